@@ -0,0 +1,170 @@
+#ifndef __egldesktopext_h_
+#define __egldesktopext_h_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Extensions of the EGL desktop implementation.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) since 2014 Norbert Nopper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * These extensions are specific to this library and are not registered with
+ * Khronos. The enumerants are taken from 0x3F00 upwards. Entry points are
+ * exported and can also be queried with eglGetProcAddress.
+ */
+
+#include <EGL/eglplatform.h>
+#include <EGL/eglext.h>
+
+#ifndef EGL_DESKTOP_display_statistics
+#define EGL_DESKTOP_display_statistics 1
+#define EGL_MAKE_CURRENT_CALLS_DESKTOP    0x3F00
+#define EGL_MAKE_CURRENT_SKIPPED_DESKTOP  0x3F01
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLQUERYDISPLAYSTATISTICSDESKTOPPROC) (EGLDisplay dpy, EGLint attribute, EGLAttrib *value);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglQueryDisplayStatisticsDESKTOP (EGLDisplay dpy, EGLint attribute, EGLAttrib *value);
+#endif
+#endif /* EGL_DESKTOP_display_statistics */
+
+#ifndef EGL_DESKTOP_no_validation
+#define EGL_DESKTOP_no_validation 1
+#define EGL_NO_VALIDATION_DESKTOP         0x3F02
+#endif /* EGL_DESKTOP_no_validation */
+
+#ifndef EGL_DESKTOP_present_queue
+#define EGL_DESKTOP_present_queue 1
+#define EGL_PRESENT_QUEUE_DEPTH_DESKTOP   0x3F03
+#endif /* EGL_DESKTOP_present_queue */
+
+#ifndef EGL_DESKTOP_frames_in_flight
+#define EGL_DESKTOP_frames_in_flight 1
+#define EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP  0x3F04
+#endif /* EGL_DESKTOP_frames_in_flight */
+
+#ifndef EGL_DESKTOP_frame_timestamps
+#define EGL_DESKTOP_frame_timestamps 1
+#define EGL_TIMESTAMPS_DESKTOP            0x3F05
+#define EGL_SWAP_REQUESTED_TIME_DESKTOP   0x3F06
+#define EGL_RENDERING_COMPLETE_TIME_DESKTOP 0x3F07
+#define EGL_DISPLAY_PRESENT_TIME_DESKTOP  0x3F08
+#define EGL_TIMESTAMP_PENDING_DESKTOP     -2
+#define EGL_TIMESTAMP_INVALID_DESKTOP     -1
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLGETNEXTFRAMEIDDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId);
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLGETFRAMETIMESTAMPSDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglGetNextFrameIdDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId);
+EGLAPI EGLBoolean EGLAPIENTRY eglGetFrameTimestampsDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values);
+#endif
+#endif /* EGL_DESKTOP_frame_timestamps */
+
+#ifndef EGL_DESKTOP_swap_group
+#define EGL_DESKTOP_swap_group 1
+#define EGL_SWAP_GROUP_DESKTOP            0x3F09
+#endif /* EGL_DESKTOP_swap_group */
+
+#ifndef EGL_DESKTOP_swap_buffers_batch
+#define EGL_DESKTOP_swap_buffers_batch 1
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLSWAPBUFFERSBATCHDESKTOPPROC) (EGLDisplay dpy, EGLint count, const EGLSurface *surfaces, const EGLint *const *rects, const EGLint *n_rects);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersBatchDESKTOP (EGLDisplay dpy, EGLint count, const EGLSurface *surfaces, const EGLint *const *rects, const EGLint *n_rects);
+#endif
+#endif /* EGL_DESKTOP_swap_buffers_batch */
+
+#ifndef EGL_DESKTOP_frame_export
+#define EGL_DESKTOP_frame_export 1
+#define EGL_FRAME_EXPORT_DESKTOP          0x3F0A
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLGETEXPORTEDFRAMEDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId, void **pixels, EGLint *width, EGLint *height, EGLint *pitch);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglGetExportedFrameDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId, void **pixels, EGLint *width, EGLint *height, EGLint *pitch);
+#endif
+#endif /* EGL_DESKTOP_frame_export */
+
+#ifndef EGL_DESKTOP_frame_export_yuv
+#define EGL_DESKTOP_frame_export_yuv 1
+#define EGL_FRAME_EXPORT_FORMAT_DESKTOP   0x3F0B
+#define EGL_FRAME_EXPORT_RGBA_DESKTOP     0x3F0C
+#define EGL_FRAME_EXPORT_NV12_DESKTOP     0x3F0D
+#define EGL_FRAME_EXPORT_I420_DESKTOP     0x3F0E
+/*
+ * NV12 and I420 frames are converted by a draw call of the rendering context,
+ * which copies the color buffer into a texture first. Only 1.5 instead of 4
+ * bytes per pixel are read back, but with a software renderer the copy and
+ * the conversion cost more than they save. Setting the format fails with
+ * EGL_BAD_MATCH, if the surface is current and the conversion can not be
+ * compiled.
+ */
+#endif /* EGL_DESKTOP_frame_export_yuv */
+
+#ifndef EGL_DESKTOP_frame_ring
+#define EGL_DESKTOP_frame_ring 1
+#define EGL_FRAME_RING_SLOTS_DESKTOP      0x3F0F
+#define EGL_FRAME_RING_TIMEOUT_DESKTOP    0x3F10
+#define EGL_FRAME_RING_MAX_SLOTS_DESKTOP  16
+#define EGL_FRAME_RING_MAGIC_DESKTOP      0x47525246
+/*
+ * The ring is shared through the file descriptor of eglCreateFrameRingDESKTOP
+ * and starts with EGLFrameRingDESKTOP. Frame n is stored in slot
+ * n % slotCount at slotOffset + slot * slotSize. slotCount is a power of two,
+ * so the slot stays right, when the counters wrap. Pixels are RGBA and rows
+ * are bottom up, as returned by glReadPixels. The producer increments written
+ * after a frame is complete. The consumer increments read after it is done
+ * with the oldest frame. Both counters wrap around and are futex words, which
+ * are woken after each change. closed is set, when the ring is destroyed.
+ */
+typedef struct EGLFrameRingSlotDESKTOP
+{
+    EGLuint64KHR frameId;
+    EGLint width;
+    EGLint height;
+    EGLint pitch;
+    EGLint reserved;
+} EGLFrameRingSlotDESKTOP;
+typedef struct EGLFrameRingDESKTOP
+{
+    khronos_uint32_t magic;
+    khronos_uint32_t slotCount;
+    khronos_uint32_t written;
+    khronos_uint32_t read;
+    khronos_uint32_t closed;
+    khronos_uint32_t reserved[3];
+    EGLuint64KHR slotOffset;
+    EGLuint64KHR slotSize;
+    EGLFrameRingSlotDESKTOP slots[EGL_FRAME_RING_MAX_SLOTS_DESKTOP];
+} EGLFrameRingDESKTOP;
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLCREATEFRAMERINGDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLint *fd);
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLDESTROYFRAMERINGDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglCreateFrameRingDESKTOP (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLint *fd);
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyFrameRingDESKTOP (EGLDisplay dpy, EGLSurface surface);
+#endif
+#endif /* EGL_DESKTOP_frame_ring */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -25,6 +25,8 @@
  */
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <EGL/egldesktopext.h>
 
 //
 // Native external implementations.
@@ -36,8 +38,14 @@
 
 extern EGLBoolean _eglChooseConfig (EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config);
 
+extern EGLBoolean _eglCopyBuffers (EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target);
+
 extern EGLContext _eglCreateContext (EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list);
 
+extern EGLSurface _eglCreatePixmapSurface (EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list);
+
+extern EGLSurface _eglCreatePbufferSurface (EGLDisplay dpy, EGLConfig config, const EGLint *attrib_list);
+
 extern EGLSurface _eglCreateWindowSurface (EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list);
 
 extern EGLBoolean _eglDestroyContext (EGLDisplay dpy, EGLContext ctx);
@@ -78,6 +86,12 @@ extern EGLBoolean _eglWaitNative (EGLint engine);
 // EGL_VERSION_1_1
 //
 
+extern EGLBoolean _eglBindTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer);
+
+extern EGLBoolean _eglReleaseTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer);
+
+extern EGLBoolean _eglSurfaceAttrib (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value);
+
 extern EGLBoolean _eglSwapInterval (EGLDisplay dpy, EGLint interval);
 
 //
@@ -104,6 +118,79 @@ EGLContext _eglGetCurrentContext (void);
 // EGL_VERSION_1_5
 //
 
+extern EGLDisplay _eglGetPlatformDisplay (EGLenum platform, void *native_display, const EGLAttrib *attrib_list);
+extern EGLSurface _eglCreatePlatformPixmapSurface (EGLDisplay dpy, EGLConfig config, void *native_pixmap, const EGLAttrib *attrib_list);
+
+extern EGLImage _eglCreateImage (EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
+
+extern EGLBoolean _eglDestroyImage (EGLDisplay dpy, EGLImage image);
+
+//
+// EGL_KHR_swap_buffers_with_damage
+//
+
+extern EGLBoolean _eglSwapBuffersWithDamage (EGLDisplay dpy, EGLSurface surface, const EGLint *rects, EGLint n_rects);
+
+//
+// EGL_KHR_partial_update
+//
+
+extern EGLBoolean _eglSetDamageRegion (EGLDisplay dpy, EGLSurface surface, const EGLint *rects, EGLint n_rects);
+
+//
+// EGL_DESKTOP_display_statistics
+//
+
+extern EGLBoolean _eglQueryDisplayStatistics (EGLDisplay dpy, EGLint attribute, EGLAttrib *value);
+
+//
+// EGL_ANDROID_presentation_time
+//
+
+extern EGLBoolean _eglPresentationTime (EGLDisplay dpy, EGLSurface surface, EGLnsecsANDROID time);
+
+//
+// EGL_DESKTOP_frame_timestamps
+//
+
+extern EGLBoolean _eglGetNextFrameId (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId);
+
+extern EGLBoolean _eglGetFrameTimestamps (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values);
+
+//
+// EGL_DESKTOP_swap_buffers_batch
+//
+
+extern EGLBoolean _eglSwapBuffersBatch (EGLDisplay dpy, EGLint count, const EGLSurface *surfaces, const EGLint *const *rects, const EGLint *n_rects);
+
+//
+// EGL_DESKTOP_frame_export
+//
+
+extern EGLBoolean _eglGetExportedFrame (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId, void **pixels, EGLint *width, EGLint *height, EGLint *pitch);
+
+//
+// EGL_DESKTOP_frame_ring
+//
+
+extern EGLBoolean _eglCreateFrameRing (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLint *fd);
+
+extern EGLBoolean _eglDestroyFrameRing (EGLDisplay dpy, EGLSurface surface);
+
+//
+// EGL_KHR_lock_surface
+//
+
+extern EGLBoolean _eglLockSurface (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list);
+
+extern EGLBoolean _eglUnlockSurface (EGLDisplay dpy, EGLSurface surface);
+
+//
+// EGL_KHR_lock_surface3
+//
+
+extern EGLBoolean _eglQuerySurface64 (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value);
+
 //
 // Wrapper.
 //
@@ -119,9 +206,7 @@ EGLAPI EGLBoolean EGLAPIENTRY eglChooseConfig (EGLDisplay dpy, const EGLint *att
 
 EGLAPI EGLBoolean EGLAPIENTRY eglCopyBuffers (EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglCopyBuffers (dpy, surface, target);
 }
 
 EGLAPI EGLContext EGLAPIENTRY eglCreateContext (EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
@@ -131,16 +216,12 @@ EGLAPI EGLContext EGLAPIENTRY eglCreateContext (EGLDisplay dpy, EGLConfig config
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePbufferSurface (EGLDisplay dpy, EGLConfig config, const EGLint *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_SURFACE;
+	return _eglCreatePbufferSurface (dpy, config, attrib_list);
 }
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePixmapSurface (EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_SURFACE;
+	return _eglCreatePixmapSurface (dpy, config, pixmap, attrib_list);
 }
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreateWindowSurface (EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
@@ -254,23 +335,17 @@ EGLAPI EGLBoolean EGLAPIENTRY eglWaitNative (EGLint engine)
 
 EGLAPI EGLBoolean EGLAPIENTRY eglBindTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglBindTexImage (dpy, surface, buffer);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglReleaseTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglReleaseTexImage (dpy, surface, buffer);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglSurfaceAttrib (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglSurfaceAttrib (dpy, surface, attribute, value);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglSwapInterval (EGLDisplay dpy, EGLint interval)
@@ -358,23 +433,17 @@ EGLAPI EGLBoolean EGLAPIENTRY eglGetSyncAttrib (EGLDisplay dpy, EGLSync sync, EG
 
 EGLAPI EGLImage EGLAPIENTRY eglCreateImage (EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_IMAGE;
+	return _eglCreateImage (dpy, ctx, target, buffer, attrib_list);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglDestroyImage (EGLDisplay dpy, EGLImage image)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglDestroyImage (dpy, image);
 }
 
 EGLAPI EGLDisplay EGLAPIENTRY eglGetPlatformDisplay (EGLenum platform, void *native_display, const EGLAttrib *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_DISPLAY;
+	return _eglGetPlatformDisplay (platform, native_display, attrib_list);
 }
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePlatformWindowSurface (EGLDisplay dpy, EGLConfig config, void *native_window, const EGLAttrib *attrib_list)
@@ -386,9 +455,7 @@ EGLAPI EGLSurface EGLAPIENTRY eglCreatePlatformWindowSurface (EGLDisplay dpy, EG
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePlatformPixmapSurface (EGLDisplay dpy, EGLConfig config, void *native_pixmap, const EGLAttrib *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_SURFACE;
+	return _eglCreatePlatformPixmapSurface (dpy, config, native_pixmap, attrib_list);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglWaitSync (EGLDisplay dpy, EGLSync sync, EGLint flags)
@@ -397,3 +464,131 @@ EGLAPI EGLBoolean EGLAPIENTRY eglWaitSync (EGLDisplay dpy, EGLSync sync, EGLint
 
 	return EGL_FALSE;
 }
+
+//
+// EGL_KHR_image_base
+//
+
+EGLAPI EGLImageKHR EGLAPIENTRY eglCreateImageKHR (EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list)
+{
+	return _eglCreateImage (dpy, ctx, target, buffer, attrib_list);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyImageKHR (EGLDisplay dpy, EGLImageKHR image)
+{
+	return _eglDestroyImage (dpy, image);
+}
+
+//
+// EGL_KHR_swap_buffers_with_damage
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersWithDamageKHR (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return _eglSwapBuffersWithDamage (dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_EXT_swap_buffers_with_damage
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersWithDamageEXT (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return _eglSwapBuffersWithDamage (dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_KHR_partial_update
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSetDamageRegionKHR (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return _eglSetDamageRegion (dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_DESKTOP_display_statistics
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQueryDisplayStatisticsDESKTOP (EGLDisplay dpy, EGLint attribute, EGLAttrib *value)
+{
+	return _eglQueryDisplayStatistics (dpy, attribute, value);
+}
+
+//
+// EGL_ANDROID_presentation_time
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglPresentationTimeANDROID (EGLDisplay dpy, EGLSurface surface, EGLnsecsANDROID time)
+{
+	return _eglPresentationTime (dpy, surface, time);
+}
+
+//
+// EGL_DESKTOP_frame_timestamps
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetNextFrameIdDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId)
+{
+	return _eglGetNextFrameId (dpy, surface, frameId);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetFrameTimestampsDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values)
+{
+	return _eglGetFrameTimestamps (dpy, surface, frameId, numTimestamps, timestamps, values);
+}
+
+//
+// EGL_DESKTOP_swap_buffers_batch
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersBatchDESKTOP (EGLDisplay dpy, EGLint count, const EGLSurface *surfaces, const EGLint *const *rects, const EGLint *n_rects)
+{
+	return _eglSwapBuffersBatch (dpy, count, surfaces, rects, n_rects);
+}
+
+//
+// EGL_DESKTOP_frame_export
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetExportedFrameDESKTOP (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId, void **pixels, EGLint *width, EGLint *height, EGLint *pitch)
+{
+	return _eglGetExportedFrame (dpy, surface, frameId, pixels, width, height, pitch);
+}
+
+//
+// EGL_DESKTOP_frame_ring
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglCreateFrameRingDESKTOP (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLint *fd)
+{
+	return _eglCreateFrameRing (dpy, surface, attrib_list, fd);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyFrameRingDESKTOP (EGLDisplay dpy, EGLSurface surface)
+{
+	return _eglDestroyFrameRing (dpy, surface);
+}
+
+//
+// EGL_KHR_lock_surface
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglLockSurfaceKHR (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list)
+{
+	return _eglLockSurface (dpy, surface, attrib_list);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglUnlockSurfaceKHR (EGLDisplay dpy, EGLSurface surface)
+{
+	return _eglUnlockSurface (dpy, surface);
+}
+
+//
+// EGL_KHR_lock_surface3
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQuerySurface64KHR (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value)
+{
+	return _eglQuerySurface64 (dpy, surface, attribute, value);
+}
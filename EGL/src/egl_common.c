@@ -32,14 +32,168 @@
 #define EGL_THREADLOCAL __thread
 #endif
 
+// Not known by older GL headers.
+#if !defined(GL_AMD_pinned_memory)
+#define GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD 0x9160
+#endif
+
 static EGL_THREADLOCAL LocalStorage g_localStorage =
     {{0, 0, 0}, EGL_SUCCESS, EGL_NONE, 0, EGL_NO_CONTEXT };
 
 #if defined(EGL_NO_GLEW)
 extern void (*glFinish_PTR)();
+extern GLsync (*glFenceSync_PTR)(GLenum, GLbitfield);
+extern GLenum (*glClientWaitSync_PTR)(GLsync, GLbitfield, GLuint64);
+extern void (*glDeleteSync_PTR)(GLsync);
+extern void (*glGenBuffers_PTR)(GLsizei, GLuint*);
+extern void (*glDeleteBuffers_PTR)(GLsizei, const GLuint*);
+extern void (*glBindBuffer_PTR)(GLenum, GLuint);
+extern void (*glBufferData_PTR)(GLenum, GLsizeiptr, const void*, GLenum);
+extern void* (*glMapBufferRange_PTR)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+extern GLboolean (*glUnmapBuffer_PTR)(GLenum);
+extern void (*glBindFramebuffer_PTR)(GLenum, GLuint);
+extern GLuint (*glCreateShader_PTR)(GLenum);
+extern void (*glShaderSource_PTR)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+extern void (*glCompileShader_PTR)(GLuint);
+extern void (*glGetShaderiv_PTR)(GLuint, GLenum, GLint*);
+extern void (*glDeleteShader_PTR)(GLuint);
+extern GLuint (*glCreateProgram_PTR)(void);
+extern void (*glAttachShader_PTR)(GLuint, GLuint);
+extern void (*glLinkProgram_PTR)(GLuint);
+extern void (*glGetProgramiv_PTR)(GLuint, GLenum, GLint*);
+extern void (*glDeleteProgram_PTR)(GLuint);
+extern void (*glUseProgram_PTR)(GLuint);
+extern GLint (*glGetUniformLocation_PTR)(GLuint, const GLchar*);
+extern void (*glUniform1i_PTR)(GLint, GLint);
+extern void (*glUniform2i_PTR)(GLint, GLint, GLint);
+extern void (*glActiveTexture_PTR)(GLenum);
+extern void (*glGenFramebuffers_PTR)(GLsizei, GLuint*);
+extern void (*glDeleteFramebuffers_PTR)(GLsizei, const GLuint*);
+extern void (*glFramebufferTexture2D_PTR)(GLenum, GLenum, GLenum, GLuint, GLint);
+extern void (*glGenVertexArrays_PTR)(GLsizei, GLuint*);
+extern void (*glBindVertexArray_PTR)(GLuint);
+extern void (*glDeleteVertexArrays_PTR)(GLsizei, const GLuint*);
+extern void (*glBindSampler_PTR)(GLuint, GLuint);
+extern const GLubyte* (*glGetStringi_PTR)(GLenum, GLuint);
+extern void (*glBlitFramebuffer_PTR)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+extern void (*glBufferStorage_PTR)(GLenum, GLsizeiptr, const void*, GLbitfield);
 #define glFinish(...) glFinish_PTR(__VA_ARGS__)
+#define glFenceSync(...) glFenceSync_PTR(__VA_ARGS__)
+#define glClientWaitSync(...) glClientWaitSync_PTR(__VA_ARGS__)
+#define glDeleteSync(...) glDeleteSync_PTR(__VA_ARGS__)
+#define glGenBuffers(...) glGenBuffers_PTR(__VA_ARGS__)
+#define glDeleteBuffers(...) glDeleteBuffers_PTR(__VA_ARGS__)
+#define glBindBuffer(...) glBindBuffer_PTR(__VA_ARGS__)
+#define glBufferData(...) glBufferData_PTR(__VA_ARGS__)
+#define glMapBufferRange(...) glMapBufferRange_PTR(__VA_ARGS__)
+#define glUnmapBuffer(...) glUnmapBuffer_PTR(__VA_ARGS__)
+#define glBindFramebuffer(...) glBindFramebuffer_PTR(__VA_ARGS__)
+#define glCreateShader(...) glCreateShader_PTR(__VA_ARGS__)
+#define glShaderSource(...) glShaderSource_PTR(__VA_ARGS__)
+#define glCompileShader(...) glCompileShader_PTR(__VA_ARGS__)
+#define glGetShaderiv(...) glGetShaderiv_PTR(__VA_ARGS__)
+#define glDeleteShader(...) glDeleteShader_PTR(__VA_ARGS__)
+#define glCreateProgram(...) glCreateProgram_PTR(__VA_ARGS__)
+#define glAttachShader(...) glAttachShader_PTR(__VA_ARGS__)
+#define glLinkProgram(...) glLinkProgram_PTR(__VA_ARGS__)
+#define glGetProgramiv(...) glGetProgramiv_PTR(__VA_ARGS__)
+#define glDeleteProgram(...) glDeleteProgram_PTR(__VA_ARGS__)
+#define glUseProgram(...) glUseProgram_PTR(__VA_ARGS__)
+#define glGetUniformLocation(...) glGetUniformLocation_PTR(__VA_ARGS__)
+#define glUniform1i(...) glUniform1i_PTR(__VA_ARGS__)
+#define glUniform2i(...) glUniform2i_PTR(__VA_ARGS__)
+#define glActiveTexture(...) glActiveTexture_PTR(__VA_ARGS__)
+#define glGenFramebuffers(...) glGenFramebuffers_PTR(__VA_ARGS__)
+#define glDeleteFramebuffers(...) glDeleteFramebuffers_PTR(__VA_ARGS__)
+#define glFramebufferTexture2D(...) glFramebufferTexture2D_PTR(__VA_ARGS__)
+#define glGenVertexArrays(...) glGenVertexArrays_PTR(__VA_ARGS__)
+#define glBindVertexArray(...) glBindVertexArray_PTR(__VA_ARGS__)
+#define glDeleteVertexArrays(...) glDeleteVertexArrays_PTR(__VA_ARGS__)
+#define glBindSampler(...) glBindSampler_PTR(__VA_ARGS__)
+#define glGetStringi(...) glGetStringi_PTR(__VA_ARGS__)
+#define glBlitFramebuffer(...) glBlitFramebuffer_PTR(__VA_ARGS__)
+#define glBufferStorage(...) glBufferStorage_PTR(__VA_ARGS__)
 #endif
 
+//
+// Extensions, which are implemented in this library.
+//
+
+EGLImage _eglCreateImage(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
+
+EGLBoolean _eglDestroyImage(EGLDisplay dpy, EGLImage image);
+
+void APIENTRY _glEGLImageTargetTexture2DOES(GLenum target, void* image);
+
+EGLBoolean _eglSwapBuffersWithDamage(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects);
+
+EGLBoolean _eglSetDamageRegion(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects);
+
+EGLBoolean _eglQueryDisplayStatistics(EGLDisplay dpy, EGLint attribute, EGLAttrib* value);
+
+EGLBoolean _eglPresentationTime(EGLDisplay dpy, EGLSurface surface, EGLnsecsANDROID time);
+
+EGLBoolean _eglGetNextFrameId(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR* frameId);
+
+EGLBoolean _eglGetFrameTimestamps(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint* timestamps, EGLnsecsANDROID* values);
+
+EGLBoolean _eglSwapBuffersBatch(EGLDisplay dpy, EGLint count, const EGLSurface* surfaces, const EGLint* const* rects, const EGLint* n_rects);
+
+EGLBoolean _eglGetExportedFrame(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR* frameId, void** pixels, EGLint* width, EGLint* height, EGLint* pitch);
+
+EGLBoolean _eglCreateFrameRing(EGLDisplay dpy, EGLSurface surface, const EGLint* attrib_list, EGLint* fd);
+
+EGLBoolean _eglDestroyFrameRing(EGLDisplay dpy, EGLSurface surface);
+
+EGLBoolean _eglLockSurface(EGLDisplay dpy, EGLSurface surface, const EGLint* attrib_list);
+
+EGLBoolean _eglUnlockSurface(EGLDisplay dpy, EGLSurface surface);
+
+EGLBoolean _eglQuerySurface64(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR* value);
+
+typedef struct _EGLProcAddressImpl
+{
+
+	const char* procname;
+
+	__eglMustCastToProperFunctionPointerType address;
+
+} EGLProcAddressImpl;
+
+static const EGLProcAddressImpl g_procAddresses[] = {
+		// EGL_KHR_image_base
+		{ "eglCreateImageKHR", (__eglMustCastToProperFunctionPointerType)_eglCreateImage },
+		{ "eglDestroyImageKHR", (__eglMustCastToProperFunctionPointerType)_eglDestroyImage },
+		// GL_OES_EGL_image
+		{ "glEGLImageTargetTexture2DOES", (__eglMustCastToProperFunctionPointerType)_glEGLImageTargetTexture2DOES },
+		// EGL_KHR_swap_buffers_with_damage
+		{ "eglSwapBuffersWithDamageKHR", (__eglMustCastToProperFunctionPointerType)_eglSwapBuffersWithDamage },
+		// EGL_EXT_swap_buffers_with_damage
+		{ "eglSwapBuffersWithDamageEXT", (__eglMustCastToProperFunctionPointerType)_eglSwapBuffersWithDamage },
+		// EGL_KHR_partial_update
+		{ "eglSetDamageRegionKHR", (__eglMustCastToProperFunctionPointerType)_eglSetDamageRegion },
+		// EGL_DESKTOP_display_statistics
+		{ "eglQueryDisplayStatisticsDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglQueryDisplayStatistics },
+		// EGL_ANDROID_presentation_time
+		{ "eglPresentationTimeANDROID", (__eglMustCastToProperFunctionPointerType)_eglPresentationTime },
+		// EGL_DESKTOP_frame_timestamps
+		{ "eglGetNextFrameIdDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglGetNextFrameId },
+		{ "eglGetFrameTimestampsDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglGetFrameTimestamps },
+		// EGL_DESKTOP_swap_buffers_batch
+		{ "eglSwapBuffersBatchDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglSwapBuffersBatch },
+		// EGL_DESKTOP_frame_export
+		{ "eglGetExportedFrameDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglGetExportedFrame },
+		// EGL_DESKTOP_frame_ring
+		{ "eglCreateFrameRingDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglCreateFrameRing },
+		{ "eglDestroyFrameRingDESKTOP", (__eglMustCastToProperFunctionPointerType)_eglDestroyFrameRing },
+		// EGL_KHR_lock_surface
+		{ "eglLockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)_eglLockSurface },
+		{ "eglUnlockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)_eglUnlockSurface },
+		// EGL_KHR_lock_surface3
+		{ "eglQuerySurface64KHR", (__eglMustCastToProperFunctionPointerType)_eglQuerySurface64 },
+		{ 0, 0 }
+};
+
 static EGLBoolean _eglInternalInit()
 {
 	return __internalInit(&g_localStorage.dummy);
@@ -86,6 +240,12 @@ static void _eglInternalCleanup()
 				}
 
 				free(deleteSurface);
+
+				// The new head has not been visited yet.
+				if (tempSurface == 0)
+				{
+					continue;
+				}
 			}
 
 			tempSurface = walkerSurface;
@@ -93,6 +253,46 @@ static void _eglInternalCleanup()
 			walkerSurface = walkerSurface->next;
 		}
 
+		EGLImageImpl* tempImage = 0;
+
+		EGLImageImpl* walkerImage = walkerDpy->rootImage;
+
+		while (walkerImage)
+		{
+			if (walkerImage->destroy)
+			{
+				EGLImageImpl* deleteImage = walkerImage;
+
+				if (tempImage == 0)
+				{
+					walkerDpy->rootImage = deleteImage->next;
+
+					walkerImage = walkerDpy->rootImage;
+				}
+				else
+				{
+					tempImage->next = deleteImage->next;
+
+					walkerImage = tempImage;
+				}
+
+				free(deleteImage);
+
+				// The new head has not been visited yet.
+				if (tempImage == 0)
+				{
+					continue;
+				}
+			}
+
+			tempImage = walkerImage;
+
+			if (walkerImage)
+			{
+				walkerImage = walkerImage->next;
+			}
+		}
+
 		while (walkerCtx)
 		{
 			// Avoid deleting of a shared context.
@@ -137,6 +337,12 @@ static void _eglInternalCleanup()
 				}
 
 				free(deleteCtx);
+
+				// The new head has not been visited yet.
+				if (tempCtx == 0)
+				{
+					continue;
+				}
 			}
 
 			tempCtx = walkerCtx;
@@ -149,7 +355,7 @@ static void _eglInternalCleanup()
 
 		if (walkerDpy->destroy)
 		{
-			if (walkerDpy->rootSurface == 0 && walkerDpy->rootCtx == 0 && walkerDpy->currentDraw == EGL_NO_SURFACE && walkerDpy->currentRead == EGL_NO_SURFACE && walkerDpy->currentCtx == EGL_NO_CONTEXT)
+			if (walkerDpy->rootSurface == 0 && walkerDpy->rootCtx == 0 && walkerDpy->rootImage == 0 && walkerDpy->currentDraw == EGL_NO_SURFACE && walkerDpy->currentRead == EGL_NO_SURFACE && walkerDpy->currentCtx == EGL_NO_CONTEXT)
 			{
 				EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
 
@@ -183,6 +389,12 @@ static void _eglInternalCleanup()
 				}
 
 				free(deleteDpy);
+
+				// The new head has not been visited yet.
+				if (tempDpy == 0)
+				{
+					continue;
+				}
 			}
 		}
 
@@ -227,6 +439,7 @@ void _eglInternalSetDefaultConfig(EGLConfigImpl* config)
 	config->level = 0;
 	config->luminanceSize = 0;
 
+	config->matchFormat = EGL_NONE;
 	config->matchNativePixmap = EGL_NONE;
 	config->maxPBufferHeight = EGL_DONT_CARE;
 	config->maxPBufferPixels = EGL_DONT_CARE;
@@ -261,1287 +474,5759 @@ void _eglInternalSetDefaultConfig(EGLConfigImpl* config)
 	config->next = 0;
 }
 
-static void _eglInternalSetDontCareConfig(EGLConfigImpl* config)
+void _eglInternalAddExtension(EGLDisplayImpl* walkerDpy, const char* extension)
 {
-	if (!config)
+	if (!walkerDpy || !extension)
 	{
 		return;
 	}
 
-	config->alphaSize = EGL_DONT_CARE;
-	config->alphaMaskSize = EGL_DONT_CARE;
+	size_t length = strlen(walkerDpy->extensions);
 
-	config->bindToTextureRGB = EGL_DONT_CARE;
-	config->bindToTextureRGBA = EGL_DONT_CARE;
-	config->blueSize = EGL_DONT_CARE;
-	config->bufferSize = EGL_DONT_CARE;
+	// Extension and separating blank have to fit.
+	if (length + strlen(extension) + 2 > EXTENSIONS_STRING_SIZE)
+	{
+		return;
+	}
 
-	config->colorBufferType = EGL_DONT_CARE;
-	config->configCaveat = EGL_DONT_CARE;
-	config->configId = EGL_DONT_CARE;
-	config->conformant = EGL_DONT_CARE;
+	if (length > 0)
+	{
+		walkerDpy->extensions[length] = ' ';
 
-	config->depthSize = EGL_DONT_CARE;
+		length++;
+	}
 
-	config->greenSize = EGL_DONT_CARE;
+	strcpy(&walkerDpy->extensions[length], extension);
+}
 
-	config->level = EGL_DONT_CARE;
-	config->luminanceSize = EGL_DONT_CARE;
+static EGLint _eglInternalRectArea(const EGLint* rect)
+{
+	return rect[2] * rect[3];
+}
 
-	config->matchNativePixmap = EGL_DONT_CARE;
-	config->maxPBufferHeight = EGL_DONT_CARE;
-	config->maxPBufferPixels = EGL_DONT_CARE;
-	config->maxPBufferWidth = EGL_DONT_CARE;
-	config->maxSwapInterval = EGL_DONT_CARE;
-	config->minSwapInterval = EGL_DONT_CARE;
+static void _eglInternalUniteRects(EGLint* target, const EGLint* rect)
+{
+	EGLint left = target[0] < rect[0] ? target[0] : rect[0];
+	EGLint bottom = target[1] < rect[1] ? target[1] : rect[1];
+	EGLint right = target[0] + target[2] > rect[0] + rect[2] ? target[0] + target[2] : rect[0] + rect[2];
+	EGLint top = target[1] + target[3] > rect[1] + rect[3] ? target[1] + target[3] : rect[1] + rect[3];
+
+	target[0] = left;
+	target[1] = bottom;
+	target[2] = right - left;
+	target[3] = top - bottom;
+}
 
-	config->nativeRenderable = EGL_DONT_CARE;
-	config->nativeVisualId = EGL_DONT_CARE;
-	config->nativeVisualType = EGL_DONT_CARE;
+static EGLint _eglInternalUnitedArea(const EGLint* first, const EGLint* second)
+{
+	EGLint united[4] = { first[0], first[1], first[2], first[3] };
 
-	config->redSize = EGL_DONT_CARE;
-	config->renderableType = EGL_DONT_CARE;
+	_eglInternalUniteRects(united, second);
 
-	config->sampleBuffers = EGL_DONT_CARE;
-	config->samples = EGL_DONT_CARE;
-	config->stencilSize = EGL_DONT_CARE;
-	config->surfaceType = EGL_DONT_CARE;
+	return _eglInternalRectArea(united);
+}
 
-	config->transparentBlueValue = EGL_DONT_CARE;
-	config->transparentGreenValue = EGL_DONT_CARE;
-	config->transparentRedValue = EGL_DONT_CARE;
-	config->transparentType = EGL_DONT_CARE;
+// Clips and merges the damage rectangles. Returns 0, if a full swap is cheaper.
+static EGLint _eglInternalMergeDamage(EGLint* merged, const EGLint* rects, EGLint n_rects, EGLint width, EGLint height)
+{
+	EGLint mergedCount = 0;
 
-	// Following parameters always do care.
+	EGLint indexRect;
 
-	config->drawToWindow = EGL_TRUE;
-	config->drawToPixmap = EGL_DONT_CARE;
-	config->drawToPBuffer = EGL_DONT_CARE;
+	for (indexRect = 0; indexRect < n_rects; indexRect++)
+	{
+		const EGLint* rect = &rects[indexRect * 4];
 
-	config->doubleBuffer = EGL_TRUE;
+		EGLint left = rect[0] > 0 ? rect[0] : 0;
+		EGLint bottom = rect[1] > 0 ? rect[1] : 0;
+		EGLint right = rect[0] + rect[2] < width ? rect[0] + rect[2] : width;
+		EGLint top = rect[1] + rect[3] < height ? rect[1] + rect[3] : height;
 
-	config->next = 0;
+		if (right <= left || top <= bottom)
+		{
+			continue;
+		}
+
+		EGLint clipped[4] = { left, bottom, right - left, top - bottom };
+
+		if (mergedCount < DAMAGE_RECTS_SIZE)
+		{
+			memcpy(&merged[mergedCount * 4], clipped, sizeof(clipped));
+
+			mergedCount++;
+
+			continue;
+		}
+
+		// No space left, so grow the rectangle, which gets the least additional area.
+
+		EGLint bestIndex = 0;
+		EGLint bestGrowth = 0;
+
+		EGLint indexMerged;
+
+		for (indexMerged = 0; indexMerged < mergedCount; indexMerged++)
+		{
+			EGLint growth = _eglInternalUnitedArea(&merged[indexMerged * 4], clipped) - _eglInternalRectArea(&merged[indexMerged * 4]);
+
+			if (indexMerged == 0 || growth < bestGrowth)
+			{
+				bestIndex = indexMerged;
+				bestGrowth = growth;
+			}
+		}
+
+		_eglInternalUniteRects(&merged[bestIndex * 4], clipped);
+	}
+
+	// Every copied rectangle has a fixed cost, so unite rectangles, as long as only little undamaged area is added.
+
+	EGLBoolean changed = EGL_TRUE;
+
+	while (changed)
+	{
+		changed = EGL_FALSE;
+
+		EGLint first;
+		EGLint second;
+
+		for (first = 0; first < mergedCount && !changed; first++)
+		{
+			for (second = first + 1; second < mergedCount && !changed; second++)
+			{
+				EGLint area = _eglInternalRectArea(&merged[first * 4]) + _eglInternalRectArea(&merged[second * 4]);
+
+				if (_eglInternalUnitedArea(&merged[first * 4], &merged[second * 4]) * 4 <= area * 5)
+				{
+					_eglInternalUniteRects(&merged[first * 4], &merged[second * 4]);
+
+					mergedCount--;
+
+					memmove(&merged[second * 4], &merged[(second + 1) * 4], (size_t)(mergedCount - second) * 4 * sizeof(EGLint));
+
+					changed = EGL_TRUE;
+				}
+			}
+		}
+	}
+
+	EGLint damagedArea = 0;
+
+	for (indexRect = 0; indexRect < mergedCount; indexRect++)
+	{
+		damagedArea += _eglInternalRectArea(&merged[indexRect * 4]);
+	}
+
+	// Copying more than half of the surface is not worth it.
+	if (damagedArea * 2 > width * height)
+	{
+		return 0;
+	}
+
+	return mergedCount;
 }
 
-//
-// EGL_VERSION_1_0
-//
+static void _eglInternalEndFrame(EGLSurfaceImpl* walkerSurface)
+{
+	walkerSurface->bufferAgeQueried = EGL_FALSE;
 
-EGLBoolean _eglChooseConfig(EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config)
+	walkerSurface->damageRegionSet = EGL_FALSE;
+	walkerSurface->damageRectsCount = 0;
+
+	walkerSurface->presentationTime = 0;
+
+	// The swapped color buffer may differ from the bitmap of the next lock.
+	walkerSurface->surfaceLock.dirty = EGL_TRUE;
+}
+
+static EGLBoolean _eglInternalHasFences()
 {
-	if (!attrib_list)
+#if defined(EGL_NO_GLEW)
+	return glFenceSync_PTR && glClientWaitSync_PTR && glDeleteSync_PTR;
+#else
+	return glFenceSync && glClientWaitSync && glDeleteSync;
+#endif
+}
+
+static void _eglInternalReleaseFramesInFlight(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// Fences can only be deleted by the context, which did insert them. Otherwise, they are released together with it.
+	EGLBoolean current = g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && walkerSurface->frameFencesCtx == walkerDpy->currentCtx;
+
+	while (walkerSurface->frameFencesCount > 0)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		if (current)
+		{
+			glDeleteSync(walkerSurface->frameFences[walkerSurface->frameFencesFirst]);
+		}
 
-		return EGL_FALSE;
+		walkerSurface->frameFencesFirst = (walkerSurface->frameFencesFirst + 1) % MAX_FRAMES_IN_FLIGHT;
+		walkerSurface->frameFencesCount--;
 	}
 
-	if (!configs)
+	walkerSurface->frameFencesFirst = 0;
+	walkerSurface->frameFencesCtx = EGL_NO_CONTEXT;
+}
+
+static void _eglInternalLimitFramesInFlight(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// Fences can only be inserted by the context, which renders to the surface.
+	if (!g_localStorage.currentCtx || walkerDpy->currentCtx != g_localStorage.currentCtx || walkerDpy->currentDraw != walkerSurface)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		return;
+	}
 
-		return EGL_FALSE;
+	// Fences of another context can not be waited for. Usually, they were already deleted, when that context was released.
+	if (walkerSurface->frameFencesCtx != walkerDpy->currentCtx)
+	{
+		_eglInternalReleaseFramesInFlight(walkerDpy, walkerSurface);
+
+		walkerSurface->frameFencesCtx = walkerDpy->currentCtx;
 	}
 
-	if (config_size == 0)
+	if (walkerSurface->maxFramesInFlight == 0)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		_eglInternalReleaseFramesInFlight(walkerDpy, walkerSurface);
 
-		return EGL_FALSE;
+		return;
 	}
 
-	if (!num_config)
+	// Waits for the oldest frames, so that the current one does not exceed the limit.
+	while (walkerSurface->frameFencesCount >= walkerSurface->maxFramesInFlight)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		GLsync fence = walkerSurface->frameFences[walkerSurface->frameFencesFirst];
 
-		return EGL_FALSE;
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(fence);
+
+		walkerSurface->frameFencesFirst = (walkerSurface->frameFencesFirst + 1) % MAX_FRAMES_IN_FLIGHT;
+		walkerSurface->frameFencesCount--;
 	}
 
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+	walkerSurface->frameFences[(walkerSurface->frameFencesFirst + walkerSurface->frameFencesCount) % MAX_FRAMES_IN_FLIGHT] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	walkerSurface->frameFencesCount++;
+}
 
-	while (walkerDpy)
+static void _eglInternalReleaseFrameTimestamps(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// Fences can only be deleted by the context, which did insert them. Otherwise, they are released together with it.
+	EGLBoolean current = g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && walkerSurface->timestampsCtx == walkerDpy->currentCtx;
+
+	EGLint i;
+
+	for (i = 0; i < FRAME_TIMESTAMPS_SIZE; i++)
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
+		EGLFrameTimestampsImpl* frameTimestamps = &walkerSurface->frameTimestamps[i];
+
+		if (frameTimestamps->renderingCompleteFence)
 		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
+			if (current)
 			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
-
-				return EGL_FALSE;
+				glDeleteSync(frameTimestamps->renderingCompleteFence);
 			}
 
-			EGLint attribListIndex = 0;
-
-			EGLConfigImpl config;
+			frameTimestamps->renderingCompleteFence = 0;
+			frameTimestamps->renderingCompleteTime = EGL_TIMESTAMP_INVALID_DESKTOP;
+		}
+	}
+}
 
-			_eglInternalSetDontCareConfig(&config);
+static void _eglInternalUpdateFrameTimestamps(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLBoolean current = g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && walkerSurface->timestampsCtx == walkerDpy->currentCtx;
 
-			while (attrib_list[attribListIndex] != EGL_NONE)
-			{
-				EGLint value = attrib_list[attribListIndex + 1];
+	EGLuint64KHR presentCounter = 0;
+	EGLnsecsANDROID presentTime = 0;
 
-				switch (attrib_list[attribListIndex])
-				{
-					case EGL_ALPHA_MASK_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLBoolean presentKnown = walkerSurface->presentCounterKnown && __getPresentCounter(walkerDpy, walkerSurface, &presentCounter, &presentTime);
 
-							return EGL_FALSE;
-						}
+	EGLnsecsANDROID now = __getMonotonicTime();
 
-						config.alphaMaskSize = value;
-					}
-					break;
-					case EGL_ALPHA_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLint i;
 
-							return EGL_FALSE;
-						}
+	for (i = 0; i < FRAME_TIMESTAMPS_SIZE; i++)
+	{
+		EGLFrameTimestampsImpl* frameTimestamps = &walkerSurface->frameTimestamps[i];
 
-						config.alphaSize = value;
-					}
-					break;
-					case EGL_BIND_TO_TEXTURE_RGB:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		if (frameTimestamps->renderingCompleteFence && current)
+		{
+			GLenum status = glClientWaitSync(frameTimestamps->renderingCompleteFence, 0, 0);
 
-							return EGL_FALSE;
-						}
+			// Completion is noticed at the latest now.
+			if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+			{
+				glDeleteSync(frameTimestamps->renderingCompleteFence);
+				frameTimestamps->renderingCompleteFence = 0;
 
-						config.bindToTextureRGB = value;
-					}
-					break;
-					case EGL_BIND_TO_TEXTURE_RGBA:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+				frameTimestamps->renderingCompleteTime = now;
+			}
+		}
 
-							return EGL_FALSE;
-						}
+		if (frameTimestamps->displayPresentTime == EGL_TIMESTAMP_PENDING_DESKTOP && presentKnown)
+		{
+			if (frameTimestamps->presentCounter == presentCounter)
+			{
+				frameTimestamps->displayPresentTime = presentTime;
+			}
+			else if (frameTimestamps->presentCounter < presentCounter)
+			{
+				// Later frames are already presented, so the vertical blank of this one is not known.
+				frameTimestamps->displayPresentTime = EGL_TIMESTAMP_INVALID_DESKTOP;
+			}
+		}
+	}
+}
 
-						config.bindToTextureRGBA = value;
-					}
-					break;
-					case EGL_BLUE_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static void _eglInternalRecordFrameTimestamps(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLBoolean current = g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && walkerDpy->currentDraw == walkerSurface;
 
-							return EGL_FALSE;
-						}
+	if (current && walkerSurface->timestampsCtx != walkerDpy->currentCtx)
+	{
+		_eglInternalReleaseFrameTimestamps(walkerDpy, walkerSurface);
 
-						config.blueSize = value;
-					}
-					break;
-					case EGL_BUFFER_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		walkerSurface->timestampsCtx = walkerDpy->currentCtx;
+	}
 
-							return EGL_FALSE;
-						}
+	// The oldest frame is overwritten.
+	EGLFrameTimestampsImpl* frameTimestamps = &walkerSurface->frameTimestamps[walkerSurface->nextFrameId % FRAME_TIMESTAMPS_SIZE];
 
-						config.bufferSize = value;
-					}
-					break;
-					case EGL_COLOR_BUFFER_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_RGB_BUFFER && value != EGL_LUMINANCE_BUFFER)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (frameTimestamps->renderingCompleteFence && current)
+	{
+		glDeleteSync(frameTimestamps->renderingCompleteFence);
+	}
 
-							return EGL_FALSE;
-						}
+	frameTimestamps->frameId = walkerSurface->nextFrameId;
+	walkerSurface->nextFrameId++;
 
-						config.colorBufferType = value;
-					}
-					break;
-					case EGL_CONFIG_CAVEAT:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_SLOW_CONFIG && value != EGL_NON_CONFORMANT_CONFIG)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	frameTimestamps->swapRequestedTime = __getMonotonicTime();
 
-							return EGL_FALSE;
-						}
+	if (current && _eglInternalHasFences())
+	{
+		frameTimestamps->renderingCompleteFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frameTimestamps->renderingCompleteTime = EGL_TIMESTAMP_PENDING_DESKTOP;
+	}
+	else
+	{
+		frameTimestamps->renderingCompleteFence = 0;
+		frameTimestamps->renderingCompleteTime = EGL_TIMESTAMP_INVALID_DESKTOP;
+	}
 
-						config.configCaveat = value;
-					}
-					break;
-					case EGL_CONFIG_ID:
-					{
-						config.configId = value;
-					}
-					break;
-					case EGL_CONFORMANT:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (walkerSurface->presentCounterKnown)
+	{
+		walkerSurface->nextPresentCounter++;
 
-							return EGL_FALSE;
-						}
+		frameTimestamps->presentCounter = walkerSurface->nextPresentCounter;
+		frameTimestamps->displayPresentTime = EGL_TIMESTAMP_PENDING_DESKTOP;
+	}
+	else
+	{
+		frameTimestamps->presentCounter = 0;
+		frameTimestamps->displayPresentTime = EGL_TIMESTAMP_INVALID_DESKTOP;
+	}
+}
 
-						config.conformant = value;
-					}
-					break;
-					case EGL_DEPTH_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static EGLBoolean _eglInternalIsCurrentDraw(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	return g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && walkerDpy->currentDraw == walkerSurface;
+}
 
-							return EGL_FALSE;
-						}
+static EGLContextListImpl* _eglInternalGetCurrentCtxList(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy->currentCtx)
+	{
+		return 0;
+	}
 
-						config.depthSize = value;
-					}
-					break;
-					case EGL_GREEN_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLContextListImpl* ctxList = walkerDpy->currentCtx->rootCtxList;
 
-							return EGL_FALSE;
-						}
+	while (ctxList)
+	{
+		if (ctxList->surface == walkerSurface)
+		{
+			return ctxList;
+		}
 
-						config.greenSize = value;
-					}
-					break;
-					case EGL_LEVEL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		ctxList = ctxList->next;
+	}
 
-							return EGL_FALSE;
-						}
+	return 0;
+}
 
-						config.level = value;
-					}
-					break;
-					case EGL_LUMINANCE_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static EGLBoolean _eglInternalApplySwapInterval(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLContextListImpl* ctxList = _eglInternalGetCurrentCtxList(walkerDpy, walkerSurface);
 
-							return EGL_FALSE;
-						}
+	if (!ctxList)
+	{
+		return EGL_FALSE;
+	}
 
-						config.luminanceSize = value;
-					}
-					break;
-					case EGL_MATCH_NATIVE_PIXMAP:
-					{
-						config.matchNativePixmap = value;
-					}
-					break;
-					case EGL_NATIVE_RENDERABLE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (ctxList->swapIntervalApplied && ctxList->swapInterval == walkerSurface->swapInterval)
+	{
+		return EGL_TRUE;
+	}
 
-							return EGL_FALSE;
-						}
+	ctxList->swapInterval = walkerSurface->swapInterval;
+	ctxList->swapIntervalApplied = __swapInterval(walkerDpy, walkerSurface, walkerSurface->swapInterval);
 
-						config.nativeRenderable = value;
-					}
-					break;
-					case EGL_MAX_SWAP_INTERVAL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	return ctxList->swapIntervalApplied;
+}
 
-							return EGL_FALSE;
-						}
+static void _eglInternalSetDrawBuffer(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	EGLContextListImpl* ctxList = _eglInternalGetCurrentCtxList(walkerDpy, walkerSurface);
 
-						config.maxSwapInterval = value;
-					}
-					break;
-					case EGL_MIN_SWAP_INTERVAL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	// Otherwise, the draw buffer set by the application would be overwritten on every bind.
+	if (ctxList && ctxList->renderBufferApplied == walkerSurface->renderBuffer)
+	{
+		return;
+	}
 
-							return EGL_FALSE;
-						}
+	GLint drawFramebuffer = 0;
 
-						config.minSwapInterval = value;
-					}
-					break;
-					case EGL_RED_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+#if defined(EGL_NO_GLEW)
+	if (glBindFramebuffer_PTR)
+#else
+	if (glBindFramebuffer)
+#endif
+	{
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	}
 
-							return EGL_FALSE;
-						}
+	// The draw buffer of the window is set, so a bound framebuffer object of the application is restored afterwards.
+	if (drawFramebuffer)
+	{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	}
 
-						config.redSize = value;
-					}
-					break;
-					case EGL_SAMPLE_BUFFERS:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	glDrawBuffer(walkerSurface->renderBuffer == EGL_SINGLE_BUFFER ? GL_FRONT : GL_BACK);
 
-							return EGL_FALSE;
-						}
+	if (drawFramebuffer)
+	{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	}
 
-						config.sampleBuffers = value;
-					}
-					break;
-					case EGL_SAMPLES:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (ctxList)
+	{
+		ctxList->renderBufferApplied = walkerSurface->renderBuffer;
+	}
+}
 
-							return EGL_FALSE;
-						}
+static void _eglInternalApplyRenderBuffer(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (walkerSurface->renderBuffer == walkerSurface->requestedRenderBuffer)
+	{
+		return;
+	}
 
-						config.samples = value;
-					}
-					break;
-					case EGL_STENCIL_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	// The draw buffer is a state of the context, so the change stays pending until the surface is swapped while being current.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+	{
+		return;
+	}
 
-							return EGL_FALSE;
-						}
+	walkerSurface->renderBuffer = walkerSurface->requestedRenderBuffer;
 
-						config.stencilSize = value;
-					}
-					break;
-					case EGL_RENDERABLE_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	_eglInternalSetDrawBuffer(walkerDpy, walkerSurface);
+}
 
-							return EGL_FALSE;
-						}
+static EGLBoolean _eglInternalHasPixelBuffers()
+{
+#if defined(EGL_NO_GLEW)
+	return _eglInternalHasFences() && glGenBuffers_PTR && glDeleteBuffers_PTR && glBindBuffer_PTR && glBufferData_PTR && glMapBufferRange_PTR && glUnmapBuffer_PTR && glBindFramebuffer_PTR;
+#else
+	return _eglInternalHasFences() && glGenBuffers && glDeleteBuffers && glBindBuffer && glBufferData && glMapBufferRange && glUnmapBuffer && glBindFramebuffer;
+#endif
+}
 
-						config.renderableType = value;
-					}
-					break;
-					case EGL_SURFACE_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_MULTISAMPLE_RESOLVE_BOX_BIT | EGL_PBUFFER_BIT | EGL_PIXMAP_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT | EGL_VG_ALPHA_FORMAT_PRE_BIT | EGL_VG_COLORSPACE_LINEAR_BIT | EGL_WINDOW_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static EGLBoolean _eglInternalHasGLExtension(const char* extension)
+{
+#if defined(EGL_NO_GLEW)
+	if (!glGetStringi_PTR)
+#else
+	if (!glGetStringi)
+#endif
+	{
+		return EGL_FALSE;
+	}
 
-							return EGL_FALSE;
-						}
+	GLint count = 0;
 
-						config.surfaceType = value;
-					}
-					break;
-					case EGL_TRANSPARENT_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_TRANSPARENT_TYPE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
 
-							return EGL_FALSE;
-						}
+	GLint i;
 
-						config.transparentType = value;
-					}
-					break;
-					case EGL_TRANSPARENT_RED_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	for (i = 0; i < count; i++)
+	{
+		const GLubyte* name = glGetStringi(GL_EXTENSIONS, (GLuint)i);
 
-							return EGL_FALSE;
-						}
+		if (name && strcmp((const char*)name, extension) == 0)
+		{
+			return EGL_TRUE;
+		}
+	}
 
-						config.transparentRedValue = value;
-					}
-					break;
-					case EGL_TRANSPARENT_GREEN_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	return EGL_FALSE;
+}
 
-							return EGL_FALSE;
-						}
+static EGLBoolean _eglInternalHasColorConversion()
+{
+#if defined(EGL_NO_GLEW)
+	return glCreateShader_PTR && glShaderSource_PTR && glCompileShader_PTR && glGetShaderiv_PTR && glDeleteShader_PTR && glCreateProgram_PTR && glAttachShader_PTR && glLinkProgram_PTR && glGetProgramiv_PTR && glDeleteProgram_PTR && glUseProgram_PTR && glGetUniformLocation_PTR && glUniform1i_PTR && glUniform2i_PTR && glActiveTexture_PTR && glGenFramebuffers_PTR && glDeleteFramebuffers_PTR && glFramebufferTexture2D_PTR && glGenVertexArrays_PTR && glBindVertexArray_PTR && glDeleteVertexArrays_PTR;
+#else
+	return glCreateShader && glShaderSource && glCompileShader && glGetShaderiv && glDeleteShader && glCreateProgram && glAttachShader && glLinkProgram && glGetProgramiv && glDeleteProgram && glUseProgram && glGetUniformLocation && glUniform1i && glUniform2i && glActiveTexture && glGenFramebuffers && glDeleteFramebuffers && glFramebufferTexture2D && glGenVertexArrays && glBindVertexArray && glDeleteVertexArrays;
+#endif
+}
 
-						config.transparentGreenValue = value;
-					}
-					break;
-					case EGL_TRANSPARENT_BLUE_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static EGLBoolean _eglInternalHasSamplers()
+{
+#if defined(EGL_NO_GLEW)
+	return glBindSampler_PTR ? EGL_TRUE : EGL_FALSE;
+#else
+	return glBindSampler ? EGL_TRUE : EGL_FALSE;
+#endif
+}
 
-							return EGL_FALSE;
-						}
+// Covers the viewport with one triangle, which is generated from the vertex index.
+static const GLchar* g_colorConversionVertexShader =
+		"#version 150\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));\n"
+		"	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);\n"
+		"}\n";
+
+// Writes four bytes per fragment, as this is less work for the GPU than one byte. The luma plane is followed by the interleaved (NV12) chroma
+// or the planar (I420) chroma with half the pitch. Rows are written top down as expected by video encoders. Colors are converted as BT.601 limited range.
+// The source texture is linearly filtered, so one fetch in the center of 2x2 pixels returns their average.
+static const GLchar* g_colorConversionFragmentShader =
+		"#version 150\n"
+		"uniform sampler2D u_source;\n"
+		"uniform ivec2 u_size;\n"
+		"uniform int u_planar;\n"
+		"out vec4 fragColor;\n"
+		"const vec3 c_luma = vec3(0.257, 0.504, 0.098);\n"
+		"const vec3 c_u = vec3(-0.148, -0.291, 0.439);\n"
+		"const vec3 c_v = vec3(0.439, -0.368, -0.071);\n"
+		"float luma(ivec2 pixel)\n"
+		"{\n"
+		"	pixel = min(pixel, u_size - 1);\n"
+		"	return dot(texelFetch(u_source, ivec2(pixel.x, u_size.y - 1 - pixel.y), 0).rgb, c_luma) + 0.0625;\n"
+		"}\n"
+		"vec3 chroma(ivec2 block)\n"
+		"{\n"
+		"	vec2 center = vec2(block * 2 + 1);\n"
+		"	return texture(u_source, vec2(center.x, float(u_size.y) - center.y) / vec2(u_size)).rgb;\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	ivec2 texel = ivec2(gl_FragCoord.xy);\n"
+		"	int x = texel.x * 4;\n"
+		"	int row = texel.y - u_size.y;\n"
+		"	if (row < 0)\n"
+		"	{\n"
+		"		fragColor = vec4(luma(ivec2(x, texel.y)), luma(ivec2(x + 1, texel.y)), luma(ivec2(x + 2, texel.y)), luma(ivec2(x + 3, texel.y)));\n"
+		"	}\n"
+		"	else if (u_planar == 0)\n"
+		"	{\n"
+		"		vec3 first = chroma(ivec2(texel.x * 2, row));\n"
+		"		vec3 second = chroma(ivec2(texel.x * 2 + 1, row));\n"
+		"		fragColor = vec4(dot(first, c_u), dot(first, c_v), dot(second, c_u), dot(second, c_v)) + 0.5;\n"
+		"	}\n"
+		"	else\n"
+		"	{\n"
+		"		int chromaPitch = ((u_size.x + 7) & ~7) / 2;\n"
+		"		int planeSize = chromaPitch * ((u_size.y + 1) / 2);\n"
+		"		int index = row * chromaPitch * 2 + x;\n"
+		"		int component = index / planeSize;\n"
+		"		index -= component * planeSize;\n"
+		"		vec3 coefficients = component == 0 ? c_u : c_v;\n"
+		"		ivec2 block = ivec2(index % chromaPitch, index / chromaPitch);\n"
+		"		fragColor = vec4(dot(chroma(block), coefficients), dot(chroma(block + ivec2(1, 0)), coefficients), dot(chroma(block + ivec2(2, 0)), coefficients), dot(chroma(block + ivec2(3, 0)), coefficients)) + 0.5;\n"
+		"	}\n"
+		"}\n";
+
+static GLuint _eglInternalCompileShader(GLenum type, const GLchar* source)
+{
+	GLuint shader = glCreateShader(type);
 
-						config.transparentBlueValue = value;
-					}
-					break;
-					default:
-					{
-						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (!shader)
+	{
+		return 0;
+	}
 
-						return EGL_FALSE;
-					}
-					break;
-				}
+	GLint status = GL_FALSE;
 
-				attribListIndex += 2;
+	glShaderSource(shader, 1, &source, 0);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
 
-				// More than 28 entries can not exist.
-				if (attribListIndex >= 28 * 2)
-				{
-					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (status != GL_TRUE)
+	{
+		glDeleteShader(shader);
 
-					return EGL_FALSE;
-				}
-			}
+		return 0;
+	}
 
-			// Check, if this configuration exists.
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+	return shader;
+}
 
-			EGLint configIndex = 0;
+static EGLBoolean _eglInternalCreateColorConversion(EGLFrameExportImpl* frameExport)
+{
+	if (frameExport->program)
+	{
+		return EGL_TRUE;
+	}
 
-			while (walkerConfig && configIndex < config_size)
-			{
-				if (config.alphaMaskSize != EGL_DONT_CARE && config.alphaMaskSize != walkerConfig->alphaMaskSize)
-				{
-					walkerConfig = walkerConfig->next;
+	if (frameExport->colorConversionFailed)
+	{
+		return EGL_FALSE;
+	}
 
-					continue;
-				}
-				if (config.alphaSize != EGL_DONT_CARE && config.alphaSize != walkerConfig->alphaSize)
-				{
-					walkerConfig = walkerConfig->next;
+	GLuint vertexShader = _eglInternalCompileShader(GL_VERTEX_SHADER, g_colorConversionVertexShader);
+	GLuint fragmentShader = _eglInternalCompileShader(GL_FRAGMENT_SHADER, g_colorConversionFragmentShader);
 
-					continue;
-				}
-				if (config.bindToTextureRGB != EGL_DONT_CARE && config.bindToTextureRGB != walkerConfig->bindToTextureRGB)
-				{
-					walkerConfig = walkerConfig->next;
+	GLuint program = 0;
+	GLint status = GL_FALSE;
 
-					continue;
-				}
-				if (config.bindToTextureRGBA != EGL_DONT_CARE && config.bindToTextureRGBA != walkerConfig->bindToTextureRGBA)
-				{
-					walkerConfig = walkerConfig->next;
+	if (vertexShader && fragmentShader)
+	{
+		program = glCreateProgram();
+	}
 
-					continue;
-				}
-				if (config.blueSize != EGL_DONT_CARE && config.blueSize != walkerConfig->blueSize)
-				{
-					walkerConfig = walkerConfig->next;
+	if (program)
+	{
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+	}
 
-					continue;
-				}
-				if (config.bufferSize != EGL_DONT_CARE && config.bufferSize != walkerConfig->bufferSize)
-				{
-					walkerConfig = walkerConfig->next;
+	// Shaders are deleted together with the program.
+	if (vertexShader)
+	{
+		glDeleteShader(vertexShader);
+	}
+	if (fragmentShader)
+	{
+		glDeleteShader(fragmentShader);
+	}
 
-					continue;
-				}
-				if (config.colorBufferType != EGL_DONT_CARE && config.colorBufferType != walkerConfig->colorBufferType)
-				{
-					walkerConfig = walkerConfig->next;
+	if (status != GL_TRUE)
+	{
+		if (program)
+		{
+			glDeleteProgram(program);
+		}
 
-					continue;
-				}
-				if (config.configCaveat != EGL_DONT_CARE && config.configCaveat != walkerConfig->configCaveat)
-				{
-					walkerConfig = walkerConfig->next;
+		frameExport->colorConversionFailed = EGL_TRUE;
 
-					continue;
-				}
-				if (config.configId != EGL_DONT_CARE && config.configId != walkerConfig->configId)
-				{
-					walkerConfig = walkerConfig->next;
+		return EGL_FALSE;
+	}
 
-					continue;
-				}
-				if (config.conformant != EGL_DONT_CARE && config.conformant != walkerConfig->conformant)
-				{
-					walkerConfig = walkerConfig->next;
+	frameExport->program = program;
+	frameExport->sizeLocation = glGetUniformLocation(program, "u_size");
+	frameExport->planarLocation = glGetUniformLocation(program, "u_planar");
 
-					continue;
-				}
-				if (config.depthSize != EGL_DONT_CARE && config.depthSize != walkerConfig->depthSize)
-				{
-					walkerConfig = walkerConfig->next;
+	GLint sourceLocation = glGetUniformLocation(program, "u_source");
 
-					continue;
-				}
-				if (config.greenSize != EGL_DONT_CARE && config.greenSize != walkerConfig->greenSize)
-				{
-					walkerConfig = walkerConfig->next;
+	GLint currentProgram;
 
-					continue;
-				}
-				if (config.level != EGL_DONT_CARE && config.level != walkerConfig->level)
-				{
-					walkerConfig = walkerConfig->next;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
 
-					continue;
-				}
-				if (config.luminanceSize != EGL_DONT_CARE && config.luminanceSize != walkerConfig->luminanceSize)
-				{
-					walkerConfig = walkerConfig->next;
+	glUseProgram(program);
+	glUniform1i(sourceLocation, 0);
 
-					continue;
-				}
-				if (config.matchNativePixmap != EGL_DONT_CARE && config.matchNativePixmap != walkerConfig->matchNativePixmap)
-				{
-					walkerConfig = walkerConfig->next;
+	glUseProgram((GLuint)currentProgram);
 
-					continue;
-				}
-				if (config.nativeRenderable != EGL_DONT_CARE && config.nativeRenderable != walkerConfig->nativeRenderable)
-				{
-					walkerConfig = walkerConfig->next;
+	// Core profiles do not draw without a vertex array.
+	glGenVertexArrays(1, &frameExport->vertexArray);
+	glGenFramebuffers(1, &frameExport->framebuffer);
+	glGenTextures(1, &frameExport->sourceTexture);
+	glGenTextures(1, &frameExport->targetTexture);
 
-					continue;
-				}
-				if (config.maxSwapInterval != EGL_DONT_CARE && config.maxSwapInterval != walkerConfig->maxSwapInterval)
-				{
-					walkerConfig = walkerConfig->next;
+	return EGL_TRUE;
+}
 
-					continue;
-				}
-				if (config.minSwapInterval != EGL_DONT_CARE && config.minSwapInterval != walkerConfig->minSwapInterval)
-				{
-					walkerConfig = walkerConfig->next;
+static void _eglInternalDestroyColorConversion(EGLFrameExportImpl* frameExport)
+{
+	if (!frameExport->program)
+	{
+		return;
+	}
 
-					continue;
-				}
-				if (config.redSize != EGL_DONT_CARE && config.redSize != walkerConfig->redSize)
-				{
-					walkerConfig = walkerConfig->next;
+	glDeleteProgram(frameExport->program);
+	glDeleteVertexArrays(1, &frameExport->vertexArray);
+	glDeleteFramebuffers(1, &frameExport->framebuffer);
+	glDeleteTextures(1, &frameExport->sourceTexture);
+	glDeleteTextures(1, &frameExport->targetTexture);
+
+	frameExport->program = 0;
+	frameExport->vertexArray = 0;
+	frameExport->framebuffer = 0;
+	frameExport->sourceTexture = 0;
+	frameExport->targetTexture = 0;
+}
 
-					continue;
-				}
-				if (config.sampleBuffers != EGL_DONT_CARE && config.sampleBuffers != walkerConfig->sampleBuffers)
-				{
-					walkerConfig = walkerConfig->next;
+static void _eglInternalResizeColorConversion(EGLFrameExportImpl* frameExport, GLsizei targetHeight)
+{
+	GLint activeTexture;
+	GLint texture;
+	GLint drawFramebuffer;
+	GLint pixelUnpackBuffer;
+
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &pixelUnpackBuffer);
+
+	// Otherwise, the textures would be initialized from a buffer of the application.
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	glBindTexture(GL_TEXTURE_2D, frameExport->sourceTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, frameExport->width, frameExport->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glBindTexture(GL_TEXTURE_2D, frameExport->targetTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, frameExport->pitch / 4, targetHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frameExport->framebuffer);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frameExport->targetTexture, 0);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)pixelUnpackBuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)texture);
+	glActiveTexture((GLenum)activeTexture);
+}
 
-					continue;
-				}
-				if (config.samples != EGL_DONT_CARE && config.samples != walkerConfig->samples)
-				{
-					walkerConfig = walkerConfig->next;
+static void _eglInternalConvertFrame(EGLFrameExportImpl* frameExport, GLsizei targetHeight)
+{
+	static const GLenum capabilities[] = { GL_BLEND, GL_COLOR_LOGIC_OP, GL_CULL_FACE, GL_DEPTH_TEST, GL_FRAMEBUFFER_SRGB, GL_RASTERIZER_DISCARD, GL_SCISSOR_TEST, GL_STENCIL_TEST };
+
+	// State of the application is restored after the conversion.
+	GLint activeTexture;
+	GLint texture;
+	GLint sampler = 0;
+	GLint drawFramebuffer;
+	GLint currentProgram;
+	GLint vertexArray;
+	GLint viewport[4];
+	GLint polygonMode[2];
+	GLboolean colorMask[4];
+	GLboolean enabled[sizeof(capabilities) / sizeof(capabilities[0])];
+
+	EGLint i;
+
+	EGLBoolean samplers = _eglInternalHasSamplers();
+
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetIntegerv(GL_POLYGON_MODE, polygonMode);
+	glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+
+	// A sampler object of the application would replace the filtering of the source texture.
+	if (samplers)
+	{
+		glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+		glBindSampler(0, 0);
+	}
 
-					continue;
-				}
-				if (config.stencilSize != EGL_DONT_CARE && config.stencilSize != walkerConfig->stencilSize)
-				{
-					walkerConfig = walkerConfig->next;
+	for (i = 0; i < (EGLint)(sizeof(capabilities) / sizeof(capabilities[0])); i++)
+	{
+		enabled[i] = glIsEnabled(capabilities[i]);
 
-					continue;
-				}
-				if (config.renderableType != EGL_DONT_CARE && config.renderableType != walkerConfig->renderableType)
-				{
-					walkerConfig = walkerConfig->next;
+		glDisable(capabilities[i]);
+	}
 
-					continue;
-				}
-				if (config.surfaceType != EGL_DONT_CARE && !(config.surfaceType & walkerConfig->surfaceType))
-				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
-				}
-				if (config.transparentType != EGL_DONT_CARE && config.transparentType != walkerConfig->transparentType)
-				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
-				}
-				if (config.transparentRedValue != EGL_DONT_CARE && config.transparentRedValue != walkerConfig->transparentRedValue)
-				{
-					walkerConfig = walkerConfig->next;
+	// The color buffer is copied from the current read buffer.
+	glBindTexture(GL_TEXTURE_2D, frameExport->sourceTexture);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, frameExport->width, frameExport->height);
 
-					continue;
-				}
-				if (config.transparentGreenValue != EGL_DONT_CARE && config.transparentGreenValue != walkerConfig->transparentGreenValue)
-				{
-					walkerConfig = walkerConfig->next;
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frameExport->framebuffer);
+	glViewport(0, 0, frameExport->pitch / 4, targetHeight);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-					continue;
-				}
-				if (config.transparentBlueValue != EGL_DONT_CARE && config.transparentBlueValue != walkerConfig->transparentBlueValue)
-				{
-					walkerConfig = walkerConfig->next;
+	glUseProgram(frameExport->program);
+	glUniform2i(frameExport->sizeLocation, frameExport->width, frameExport->height);
+	glUniform1i(frameExport->planarLocation, frameExport->format == EGL_FRAME_EXPORT_I420_DESKTOP);
 
-					continue;
-				}
+	glBindVertexArray(frameExport->vertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
 
-				//
+	for (i = 0; i < (EGLint)(sizeof(capabilities) / sizeof(capabilities[0])); i++)
+	{
+		if (enabled[i])
+		{
+			glEnable(capabilities[i]);
+		}
+	}
 
-				if (config.drawToWindow != EGL_DONT_CARE && config.drawToWindow != walkerConfig->drawToWindow)
-				{
-					walkerConfig = walkerConfig->next;
+	if (samplers)
+	{
+		glBindSampler(0, (GLuint)sampler);
+	}
 
-					continue;
-				}
+	glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+	glPolygonMode(GL_FRONT_AND_BACK, (GLenum)polygonMode[0]);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glBindVertexArray((GLuint)vertexArray);
+	glUseProgram((GLuint)currentProgram);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)texture);
+	glActiveTexture((GLenum)activeTexture);
+}
 
-				if (config.drawToPixmap != EGL_DONT_CARE && config.drawToPixmap != walkerConfig->drawToPixmap)
-				{
-					walkerConfig = walkerConfig->next;
+static void _eglInternalUnmapExportedFrame(EGLFrameExportImpl* frameExport)
+{
+	if (frameExport->mapped < 0)
+	{
+		return;
+	}
 
-					continue;
-				}
+	GLint pixelPackBuffer;
 
-				if (config.drawToPBuffer != EGL_DONT_CARE && config.drawToPBuffer != walkerConfig->drawToPBuffer)
-				{
-					walkerConfig = walkerConfig->next;
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
 
-					continue;
-				}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, frameExport->pixelBuffers[frameExport->mapped]);
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 
-				if (config.doubleBuffer != EGL_DONT_CARE && config.doubleBuffer != walkerConfig->doubleBuffer)
-				{
-					walkerConfig = walkerConfig->next;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)pixelPackBuffer);
 
-					continue;
-				}
+	frameExport->mapped = -1;
+	frameExport->pixels = 0;
+}
 
-				//
+static void _eglInternalReleaseFrameExport(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLFrameExportImpl* frameExport = &walkerSurface->frameExport;
 
-				configs[configIndex] = walkerConfig;
+	// Buffers and fences can only be deleted by the context, which did create them. Otherwise, they are released together with it.
+	if (frameExport->ctx && g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && frameExport->ctx == walkerDpy->currentCtx)
+	{
+		_eglInternalUnmapExportedFrame(frameExport);
 
-				walkerConfig = walkerConfig->next;
+		EGLint i;
 
-				configIndex++;
+		for (i = 0; i < FRAME_EXPORT_RING_SIZE; i++)
+		{
+			if (frameExport->fences[i])
+			{
+				glDeleteSync(frameExport->fences[i]);
 			}
+		}
 
-			*num_config = configIndex;
-
-			return EGL_TRUE;
+		if (frameExport->pixelBuffers[0])
+		{
+			glDeleteBuffers(FRAME_EXPORT_RING_SIZE, frameExport->pixelBuffers);
 		}
 
-		walkerDpy = walkerDpy->next;
+		_eglInternalDestroyColorConversion(frameExport);
 	}
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+	// Frame identifiers keep counting.
+	EGLuint64KHR nextFrameId = frameExport->nextFrameId;
 
-	return EGL_FALSE;
+	memset(frameExport, 0, sizeof(EGLFrameExportImpl));
+	frameExport->mapped = -1;
+	frameExport->nextFrameId = nextFrameId;
 }
 
-EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
+// Objects of the export belong to the current context, so the ones of another context are released before.
+static void _eglInternalBindFrameExport(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
 {
-	if (!attrib_list)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
+	EGLFrameExportImpl* frameExport = &walkerSurface->frameExport;
 
-	if (g_localStorage.api == EGL_NONE)
+	if (frameExport->ctx != walkerDpy->currentCtx)
 	{
-		g_localStorage.error = EGL_BAD_MATCH;
+		_eglInternalReleaseFrameExport(walkerDpy, walkerSurface);
 
-		return EGL_NO_CONTEXT;
+		frameExport->ctx = walkerDpy->currentCtx;
 	}
+}
 
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+static void _eglInternalExportFrame(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLFrameExportImpl* frameExport = &walkerSurface->frameExport;
 
-	while (walkerDpy)
+	// Pixels can only be read by the context, which renders to the surface.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
-		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+		return;
+	}
 
-				return EGL_FALSE;
-			}
+	_eglInternalBindFrameExport(walkerDpy, walkerSurface);
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+	__updateSurfaceSize(walkerDpy, walkerSurface);
 
-			while (walkerConfig)
-			{
-				if ((EGLConfig)walkerConfig == config)
-				{
-					EGLint target_attrib_list[CONTEXT_ATTRIB_LIST_SIZE];
+	if (walkerSurface->width <= 0 || walkerSurface->height <= 0)
+	{
+		return;
+	}
 
-					if (!__processAttribList(target_attrib_list, attrib_list, &g_localStorage.error))
-					{
-						return EGL_FALSE;
-					}
+	// State of the application is restored after the readback.
+	GLint pixelPackBuffer;
+	GLint readFramebuffer;
+	GLint readBuffer;
+	GLint packAlignment;
+	GLint packRowLength;
 
-					EGLContextImpl* sharedCtx = 0;
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
 
-					if (share_context != EGL_NO_CONTEXT)
-					{
-						EGLDisplayImpl* sharedWalkerDpy = g_localStorage.rootDpy;
+	// The pointer to the previous frame is no longer valid.
+	_eglInternalUnmapExportedFrame(frameExport);
 
-						while (sharedWalkerDpy)
-						{
-							EGLContextImpl* sharedWalkerCtx = sharedWalkerDpy->rootCtx;
+	EGLint i;
 
-							while (sharedWalkerCtx)
-							{
-								if ((EGLContext)sharedWalkerCtx == share_context)
-								{
-									if (!sharedWalkerCtx->initialized || sharedWalkerCtx->destroy)
-									{
-										g_localStorage.error = EGL_BAD_CONTEXT;
+	// Converted frames have a luma row for each row of the surface and a chroma row for every two rows.
+	GLsizei targetHeight = walkerSurface->height + (walkerSurface->height + 1) / 2;
 
-										return EGL_FALSE;
-									}
+	if (walkerSurface->exportFormat != EGL_FRAME_EXPORT_RGBA_DESKTOP && !_eglInternalCreateColorConversion(frameExport))
+	{
+		return;
+	}
 
-									sharedCtx = sharedWalkerCtx;
+	if (!frameExport->pixelBuffers[0] || frameExport->width != walkerSurface->width || frameExport->height != walkerSurface->height || frameExport->format != walkerSurface->exportFormat)
+	{
+		// Frames of the old size or format are dropped.
+		for (i = 0; i < FRAME_EXPORT_RING_SIZE; i++)
+		{
+			if (frameExport->fences[i])
+			{
+				glDeleteSync(frameExport->fences[i]);
 
-									break;
-								}
+				frameExport->fences[i] = 0;
+			}
+		}
 
-								sharedWalkerCtx = sharedWalkerCtx->next;
-							}
+		if (!frameExport->pixelBuffers[0])
+		{
+			glGenBuffers(FRAME_EXPORT_RING_SIZE, frameExport->pixelBuffers);
+		}
 
-							sharedWalkerDpy = sharedWalkerDpy->next;
-						}
+		frameExport->width = walkerSurface->width;
+		frameExport->height = walkerSurface->height;
+		frameExport->format = walkerSurface->exportFormat;
 
-						if (!sharedCtx)
-						{
-							g_localStorage.error = EGL_BAD_CONTEXT;
+		if (frameExport->format == EGL_FRAME_EXPORT_RGBA_DESKTOP)
+		{
+			frameExport->pitch = frameExport->width * 4;
+			frameExport->size = (GLsizeiptr)frameExport->pitch * frameExport->height;
+		}
+		else
+		{
+			// Four bytes are written together, which must not cross the rows of the chroma planes with half the pitch.
+			frameExport->pitch = (frameExport->width + 7) & ~7;
+			frameExport->size = (GLsizeiptr)frameExport->pitch * targetHeight;
 
-							return EGL_FALSE;
-						}
-					}
+			_eglInternalResizeColorConversion(frameExport, targetHeight);
+		}
 
-					EGLContextImpl* newCtx = (EGLContextImpl*)malloc(sizeof(EGLContextImpl));
+		for (i = 0; i < FRAME_EXPORT_RING_SIZE; i++)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, frameExport->pixelBuffers[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, frameExport->size, 0, GL_STREAM_READ);
+		}
+	}
 
-					if (!newCtx)
-					{
-						g_localStorage.error = EGL_BAD_ALLOC;
+	EGLint slot = frameExport->next;
 
-						return EGL_FALSE;
-					}
+	// A frame, which has not been mapped in time, is overwritten.
+	if (frameExport->fences[slot])
+	{
+		glDeleteSync(frameExport->fences[slot]);
 
-					// Move the atttibutes for later creation.
-					memcpy(newCtx->attribList, target_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+		frameExport->fences[slot] = 0;
+	}
 
-					newCtx->initialized = EGL_TRUE;
-					newCtx->destroy = EGL_FALSE;
-					newCtx->configId = walkerConfig->configId;
-					newCtx->sharedCtx = sharedCtx;
-					newCtx->rootCtxList = 0;
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
 
-					newCtx->next = walkerDpy->rootCtx;
-					walkerDpy->rootCtx = newCtx;
+	glReadBuffer(walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT);
+	glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
-					return (EGLContext)newCtx;
-				}
+	// Pixels are copied into the buffer by the GPU, so the call does not wait for the rendering.
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, frameExport->pixelBuffers[slot]);
 
-				walkerConfig = walkerConfig->next;
-			}
+	if (frameExport->format == EGL_FRAME_EXPORT_RGBA_DESKTOP)
+	{
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, frameExport->width, frameExport->height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	}
+	else
+	{
+		_eglInternalConvertFrame(frameExport, targetHeight);
 
-			g_localStorage.error = EGL_BAD_CONFIG;
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, frameExport->framebuffer);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
 
-			return EGL_NO_CONTEXT;
-		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, frameExport->pitch / 4, targetHeight, GL_RGBA, GL_UNSIGNED_BYTE, 0);
 
-		walkerDpy = walkerDpy->next;
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 	}
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+	frameExport->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	frameExport->frameIds[slot] = frameExport->nextFrameId++;
+	frameExport->next = (slot + 1) % FRAME_EXPORT_RING_SIZE;
 
-	return EGL_NO_CONTEXT;
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glReadBuffer((GLenum)readBuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)pixelPackBuffer);
 }
 
-EGLSurface _eglCreateWindowSurface(EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
+static void _eglInternalMapExportedFrame(EGLFrameExportImpl* frameExport)
 {
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+	if (frameExport->mapped >= 0)
+	{
+		return;
+	}
 
-	while (walkerDpy)
+	EGLint i;
+
+	// The oldest frame is mapped first, so that no frame is skipped. Usually, this is the frame two swaps ago.
+	for (i = 0; i < FRAME_EXPORT_RING_SIZE; i++)
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
+		EGLint slot = (frameExport->next + i) % FRAME_EXPORT_RING_SIZE;
+
+		if (!frameExport->fences[slot])
 		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+			continue;
+		}
 
-				return EGL_NO_SURFACE;
-			}
+		// Never waits for the GPU.
+		GLenum status = glClientWaitSync(frameExport->fences[slot], 0, 0);
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			return;
+		}
 
-			while (walkerConfig)
-			{
-				if ((EGLConfig)walkerConfig == config)
-				{
-					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+		GLint pixelPackBuffer;
 
-					if (!newSurface)
-					{
-						g_localStorage.error = EGL_BAD_ALLOC;
+		glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
 
-						return EGL_NO_SURFACE;
-					}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, frameExport->pixelBuffers[slot]);
+		frameExport->pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameExport->size, GL_MAP_READ_BIT);
 
-					if (!__createWindowSurface(newSurface, win, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
-					{
-						free(newSurface);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)pixelPackBuffer);
 
-						return EGL_NO_SURFACE;
-					}
+		if (frameExport->pixels)
+		{
+			glDeleteSync(frameExport->fences[slot]);
 
-					newSurface->next = walkerDpy->rootSurface;
+			frameExport->fences[slot] = 0;
+			frameExport->mapped = slot;
+		}
 
-					walkerDpy->rootSurface = newSurface;
+		return;
+	}
+}
 
-					return (EGLSurface)newSurface;
-				}
+static void* _eglInternalGetFrameRingSlot(const EGLFrameRingImpl* frameRing, EGLint slot)
+{
+	return (char*)frameRing->header + frameRing->header->slotOffset + frameRing->header->slotSize * (EGLuint64KHR)slot;
+}
 
-				walkerConfig = walkerConfig->next;
-			}
+static void _eglInternalCreateFrameRingBuffers(EGLFrameRingImpl* frameRing)
+{
+	// Without pinned memory, pixels are read synchronously into the slots.
+	if (!_eglInternalHasGLExtension("GL_AMD_pinned_memory"))
+	{
+		return;
+	}
 
-			g_localStorage.error = EGL_BAD_CONFIG;
+	EGLint slotCount = (EGLint)frameRing->header->slotCount;
 
-			return EGL_NO_SURFACE;
-		}
+	glGenBuffers(slotCount, frameRing->pixelBuffers);
 
-		walkerDpy = walkerDpy->next;
-	}
+	EGLint i;
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+	// The buffers use the shared memory as storage, so the GPU writes directly into the slots.
+	for (i = 0; i < slotCount; i++)
+	{
+		glBindBuffer(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, frameRing->pixelBuffers[i]);
+		glBufferData(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, (GLsizeiptr)frameRing->header->slotSize, _eglInternalGetFrameRingSlot(frameRing, i), GL_STREAM_READ);
+	}
 
-	return EGL_NO_SURFACE;
+	glBindBuffer(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, 0);
 }
 
-EGLBoolean _eglDestroyContext(EGLDisplay dpy, EGLContext ctx)
+static void _eglInternalPublishFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLBoolean wait)
 {
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
-
-	while (walkerDpy)
+	// Frames are published in order, once the GPU has written them.
+	while (frameRing->pending > 0)
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
-		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+		EGLint slot = (EGLint)(frameRing->header->written % frameRing->header->slotCount);
 
-				return EGL_FALSE;
-			}
+		GLenum status;
 
-			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+		if (wait)
+		{
+			status = glClientWaitSync(frameRing->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		}
+		else
+		{
+			status = glClientWaitSync(frameRing->fences[slot], 0, 0);
+		}
 
-			while (walkerCtx)
-			{
-				if ((EGLContext)walkerCtx == ctx)
-				{
-					if (!walkerCtx->initialized || walkerCtx->destroy)
-					{
-						g_localStorage.error = EGL_BAD_CONTEXT;
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			return;
+		}
 
-						return EGL_FALSE;
-					}
+		glDeleteSync(frameRing->fences[slot]);
 
-					walkerCtx->initialized = EGL_FALSE;
-					walkerCtx->destroy = EGL_TRUE;
+		frameRing->fences[slot] = 0;
+		frameRing->pending--;
 
-					_eglInternalCleanup();
+		__publishFrameRing(walkerDpy, frameRing);
+	}
+}
 
-					return EGL_TRUE;
-				}
+static EGLContextImpl* _eglInternalGetShareRoot(EGLContextImpl* walkerCtx)
+{
+	while (walkerCtx && walkerCtx->sharedCtx)
+	{
+		walkerCtx = walkerCtx->sharedCtx;
+	}
 
-				walkerCtx = walkerCtx->next;
-			}
+	return walkerCtx;
+}
 
-			g_localStorage.error = EGL_BAD_CONTEXT;
+static void _eglInternalReleaseFrameRingObjects(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	// Buffers and fences can only be deleted by a context, which shares them with the one, which did create them. Otherwise, they are released together with it.
+	if (frameRing->ctx && g_localStorage.currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx && _eglInternalGetShareRoot(frameRing->ctx) == _eglInternalGetShareRoot(walkerDpy->currentCtx))
+	{
+		// Frames, which are already read back, still reach the consumer.
+		_eglInternalPublishFrameRing(walkerDpy, frameRing, EGL_TRUE);
 
-			return EGL_FALSE;
+		if (frameRing->pixelBuffers[0])
+		{
+			glDeleteBuffers((GLsizei)frameRing->header->slotCount, frameRing->pixelBuffers);
 		}
+	}
 
-		walkerDpy = walkerDpy->next;
+	// Frames of another context, which are still read back, are dropped.
+	memset(frameRing->fences, 0, sizeof(frameRing->fences));
+	memset(frameRing->pixelBuffers, 0, sizeof(frameRing->pixelBuffers));
+	frameRing->pending = 0;
+}
+
+static void _eglInternalReleaseFrameRing(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLFrameRingImpl* frameRing = &walkerSurface->frameRing;
+
+	if (!frameRing->header)
+	{
+		return;
 	}
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+	_eglInternalReleaseFrameRingObjects(walkerDpy, frameRing);
 
-	return EGL_FALSE;
+	__destroyFrameRing(walkerDpy, frameRing);
+
+	memset(frameRing, 0, sizeof(EGLFrameRingImpl));
+	frameRing->fd = -1;
 }
 
-EGLBoolean _eglDestroySurface(EGLDisplay dpy, EGLSurface surface)
+static void _eglInternalWriteFrameRing(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
 {
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+	EGLFrameRingImpl* frameRing = &walkerSurface->frameRing;
 
-	while (walkerDpy)
+	// Pixels can only be read by the context, which renders to the surface.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
+		return;
+	}
+
+	if (frameRing->ctx != walkerDpy->currentCtx)
+	{
+		_eglInternalReleaseFrameRingObjects(walkerDpy, frameRing);
+
+		frameRing->ctx = walkerDpy->currentCtx;
+
+		_eglInternalCreateFrameRingBuffers(frameRing);
+	}
+
+	__updateSurfaceSize(walkerDpy, walkerSurface);
+
+	if (walkerSurface->width <= 0 || walkerSurface->height <= 0)
+	{
+		return;
+	}
+
+	// Identifiers of dropped frames are skipped, so the consumer can notice them.
+	EGLuint64KHR frameId = frameRing->nextFrameId++;
+
+	// Frames, which the GPU has written meanwhile, are passed on without waiting.
+	_eglInternalPublishFrameRing(walkerDpy, frameRing, EGL_FALSE);
+
+	if (!__waitFrameRing(walkerDpy, frameRing, 0))
+	{
+		// Only published frames can be released by the consumer.
+		_eglInternalPublishFrameRing(walkerDpy, frameRing, EGL_TRUE);
+
+		// Rendering is throttled to the pace of the consumer. If it does not release a slot in time, the frame is dropped.
+		if (!__waitFrameRing(walkerDpy, frameRing, frameRing->timeout))
 		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+			return;
+		}
+	}
 
-				return EGL_FALSE;
-			}
+	EGLFrameRingDESKTOP* header = frameRing->header;
 
-			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+	EGLint slot = (EGLint)((header->written + (khronos_uint32_t)frameRing->pending) % header->slotCount);
 
-			while (walkerSurface)
-			{
-				if ((EGLSurface)walkerSurface == surface)
-				{
-					if (!walkerSurface->initialized || walkerSurface->destroy)
-					{
-						g_localStorage.error = EGL_BAD_SURFACE;
+	EGLFrameRingSlotDESKTOP* frame = &header->slots[slot];
 
-						return EGL_FALSE;
-					}
+	frame->frameId = frameId;
+	frame->width = walkerSurface->width < frameRing->maxWidth ? walkerSurface->width : frameRing->maxWidth;
+	frame->height = walkerSurface->height < frameRing->maxHeight ? walkerSurface->height : frameRing->maxHeight;
+	frame->pitch = frame->width * 4;
 
-					walkerSurface->initialized = EGL_FALSE;
-					walkerSurface->destroy = EGL_TRUE;
+	// State of the application is restored after the readback.
+	GLint pixelPackBuffer;
+	GLint readFramebuffer;
+	GLint readBuffer;
+	GLint packAlignment;
+	GLint packRowLength;
 
-					__destroySurface(walkerSurface->win, &walkerSurface->nativeSurfaceContainer);
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pixelPackBuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
 
-					_eglInternalCleanup();
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
 
-					return EGL_TRUE;
-				}
+	glReadBuffer(walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT);
+	glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
 
-				walkerSurface = walkerSurface->next;
-			}
+	if (frameRing->pixelBuffers[slot])
+	{
+		// The frame is published by a later swap, so the call does not wait for the rendering.
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, frameRing->pixelBuffers[slot]);
+		glReadPixels(0, 0, frame->width, frame->height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
 
-			g_localStorage.error = EGL_BAD_SURFACE;
+		frameRing->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frameRing->pending++;
 
-			return EGL_FALSE;
+		// Swapping pbuffers does not flush, but the readback has to start.
+		glFlush();
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glReadPixels(0, 0, frame->width, frame->height, GL_RGBA, GL_UNSIGNED_BYTE, _eglInternalGetFrameRingSlot(frameRing, slot));
+
+		__publishFrameRing(walkerDpy, frameRing);
+	}
+
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glReadBuffer((GLenum)readBuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)pixelPackBuffer);
+}
+
+static EGLBoolean _eglInternalHasSurfaceLock()
+{
+#if defined(EGL_NO_GLEW)
+	return _eglInternalHasPixelBuffers() && glGenFramebuffers_PTR && glFramebufferTexture2D_PTR && glBlitFramebuffer_PTR;
+#else
+	return _eglInternalHasPixelBuffers() && glGenFramebuffers && glFramebufferTexture2D && glBlitFramebuffer;
+#endif
+}
+
+static GLenum _eglInternalGetColorBuffer(const EGLSurfaceImpl* walkerSurface)
+{
+	return walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT;
+}
+
+// Has to be called with the lock context being current.
+static void _eglInternalAllocateSurfaceLock(EGLSurfaceLockImpl* surfaceLock, EGLint width, EGLint height)
+{
+	GLsizeiptr size = (GLsizeiptr)width * (GLsizeiptr)height * 4;
+
+	// Deleting a mapped buffer also unmaps it.
+	if (surfaceLock->pixelBuffer)
+	{
+		glDeleteBuffers(1, &surfaceLock->pixelBuffer);
+	}
+
+	surfaceLock->persistent = EGL_FALSE;
+	surfaceLock->pixels = 0;
+	surfaceLock->width = width;
+	surfaceLock->height = height;
+
+	glGenBuffers(1, &surfaceLock->pixelBuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, surfaceLock->pixelBuffer);
+
+	// Immutable storage stays mapped, while the GL reads and writes it. As the mapping is coherent, no explicit flushes are needed.
+#if defined(EGL_NO_GLEW)
+	if (glBufferStorage_PTR)
+#else
+	if (glBufferStorage)
+#endif
+	{
+		GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage(GL_PIXEL_PACK_BUFFER, size, 0, flags);
+
+		surfaceLock->pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, flags);
+
+		if (surfaceLock->pixels)
+		{
+			surfaceLock->persistent = EGL_TRUE;
+
+			return;
 		}
 
-		walkerDpy = walkerDpy->next;
+		// The storage can not be changed anymore, so the buffer is created again.
+		glDeleteBuffers(1, &surfaceLock->pixelBuffer);
+		glGenBuffers(1, &surfaceLock->pixelBuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, surfaceLock->pixelBuffer);
 	}
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+	// Without persistent mapping, the buffer is mapped on every lock.
+	glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_DYNAMIC_READ);
+}
 
-	return EGL_FALSE;
+// Has to be called with the lock context being current.
+static void _eglInternalReadSurfaceLock(const EGLSurfaceImpl* walkerSurface, EGLSurfaceLockImpl* surfaceLock)
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glReadBuffer(_eglInternalGetColorBuffer(walkerSurface));
+
+	// Packed as 32 bit values, the offsets of the components do not depend on the byte order.
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, surfaceLock->pixelBuffer);
+	glReadPixels(0, 0, surfaceLock->width, surfaceLock->height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+
+	// Mapping waits for the transfer, but a persistently mapped buffer has to be waited for explicitly.
+	if (surfaceLock->persistent)
+	{
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(fence);
+	}
+
+	surfaceLock->dirty = EGL_FALSE;
 }
 
-EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint *value)
+// Has to be called with the lock context being current and the pixel buffer being unmapped or persistent.
+static void _eglInternalWriteSurfaceLock(const EGLSurfaceImpl* walkerSurface, EGLSurfaceLockImpl* surfaceLock)
 {
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+	if (!surfaceLock->texture)
+	{
+		glGenTextures(1, &surfaceLock->texture);
+		glGenFramebuffers(1, &surfaceLock->framebuffer);
+	}
 
-	while (walkerDpy)
+	glBindTexture(GL_TEXTURE_2D, surfaceLock->texture);
+
+	if (surfaceLock->textureWidth != surfaceLock->width || surfaceLock->textureHeight != surfaceLock->height)
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, surfaceLock->width, surfaceLock->height, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, surfaceLock->framebuffer);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, surfaceLock->texture, 0);
+
+		surfaceLock->textureWidth = surfaceLock->width;
+		surfaceLock->textureHeight = surfaceLock->height;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, surfaceLock->pixelBuffer);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, surfaceLock->width, surfaceLock->height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, surfaceLock->framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glDrawBuffer(_eglInternalGetColorBuffer(walkerSurface));
+
+	glBlitFramebuffer(0, 0, surfaceLock->width, surfaceLock->height, 0, 0, surfaceLock->width, surfaceLock->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	// The CPU must not write a persistently mapped bitmap again, before the GL did read it. Waiting here, while the lock context is still bound, saves the next lock from binding it again.
+	if (surfaceLock->persistent)
+	{
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(fence);
+	}
+	else
+	{
+		glFlush();
+	}
+
+	// The color buffer now holds the bitmap.
+	surfaceLock->dirty = EGL_FALSE;
+}
+
+// The lock context of the display outlives the surface, so its objects have to be deleted explicitly.
+static void _eglInternalReleaseSurfaceLock(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLSurfaceLockImpl* surfaceLock = &walkerSurface->surfaceLock;
+
+	if (surfaceLock->pixelBuffer && __bindLockContext(walkerDpy, walkerSurface))
+	{
+		// Deleting a mapped buffer also unmaps it.
+		glDeleteBuffers(1, &surfaceLock->pixelBuffer);
+
+		if (surfaceLock->texture)
 		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+			glDeleteTextures(1, &surfaceLock->texture);
+			glDeleteFramebuffers(1, &surfaceLock->framebuffer);
+		}
 
-				return EGL_FALSE;
-			}
+		__unbindLockContext(walkerDpy, walkerSurface);
+	}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+	memset(surfaceLock, 0, sizeof(EGLSurfaceLockImpl));
+}
 
-			while (walkerConfig)
-			{
-				if ((EGLConfig)walkerConfig == config)
-				{
-					break;
-				}
+// Pixels are packed as 32 bit values with blue in the lowest byte. Rows are bottom up as in OpenGL.
+static EGLBoolean _eglInternalQueryBitmap(EGLSurfaceImpl* walkerSurface, EGLint attribute, EGLAttribKHR* value)
+{
+	EGLSurfaceLockImpl* surfaceLock = &walkerSurface->surfaceLock;
 
-				walkerConfig = walkerConfig->next;
-			}
+	if (!surfaceLock->locked)
+	{
+		g_localStorage.error = EGL_BAD_ACCESS;
 
-			if (!walkerConfig)
-			{
-				g_localStorage.error = EGL_BAD_CONFIG;
+		return EGL_FALSE;
+	}
 
-				return EGL_FALSE;
+	EGLAttribKHR result;
+
+	switch (attribute)
+	{
+		case EGL_BITMAP_POINTER_KHR:
+		{
+			result = (EGLAttribKHR)surfaceLock->pixels;
+
+			if (surfaceLock->usage & EGL_WRITE_SURFACE_BIT_KHR)
+			{
+				surfaceLock->written = EGL_TRUE;
 			}
+		}
+		break;
+		case EGL_BITMAP_PITCH_KHR:
+		{
+			result = surfaceLock->width * 4;
+		}
+		break;
+		case EGL_BITMAP_ORIGIN_KHR:
+		{
+			result = EGL_LOWER_LEFT_KHR;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_RED_OFFSET_KHR:
+		{
+			result = 16;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_GREEN_OFFSET_KHR:
+		{
+			result = 8;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_BLUE_OFFSET_KHR:
+		{
+			result = 0;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_ALPHA_OFFSET_KHR:
+		{
+			result = 24;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_LUMINANCE_OFFSET_KHR:
+		{
+			// Color buffers are always RGB.
+			result = 0;
+		}
+		break;
+		case EGL_BITMAP_PIXEL_SIZE_KHR:
+		{
+			result = 32;
+		}
+		break;
+		default:
+		{
+			g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-			switch (attribute)
+			return EGL_FALSE;
+		}
+		break;
+	}
+
+	if (value)
+	{
+		*value = result;
+	}
+
+	return EGL_TRUE;
+}
+
+static EGLBoolean _eglInternalPresent(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLBoolean result;
+
+	if (walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_SINGLE_BUFFER)
+	{
+		// Rendering to the front buffer is already visible. Swapping or copying the back buffer would overwrite it.
+		result = EGL_TRUE;
+	}
+	else if (walkerSurface->damageRegionSet && walkerSurface->damageRectsCount > 0)
+	{
+		// Only the damage region has been rendered, so only this region has to be presented.
+		result = __swapBuffersWithDamage(walkerDpy, walkerSurface, walkerSurface->damageRects, walkerSurface->damageRectsCount);
+	}
+	else
+	{
+		result = __swapBuffers(walkerDpy, walkerSurface);
+	}
+
+	// The window system did not take the frame, e.g. as the surface is not current to the calling thread.
+	if (!result)
+	{
+		g_localStorage.error = EGL_BAD_SURFACE;
+	}
+
+	_eglInternalEndFrame(walkerSurface);
+
+	return result;
+}
+
+static EGLBoolean _eglInternalIsSwapGroupMember(const EGLSurfaceImpl* walkerSurface, EGLint swapGroup)
+{
+	return walkerSurface->initialized && !walkerSurface->destroy && walkerSurface->drawToWindow && walkerSurface->swapGroup == swapGroup;
+}
+
+static EGLBoolean _eglInternalPresentSwapGroup(const EGLDisplayImpl* walkerDpy, EGLint swapGroup)
+{
+	EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+	// Frames are held, until every member of the group has been swapped.
+	while (walkerSurface)
+	{
+		if (_eglInternalIsSwapGroupMember(walkerSurface, swapGroup) && !walkerSurface->swapGroupPending)
+		{
+			return EGL_TRUE;
+		}
+
+		walkerSurface = walkerSurface->next;
+	}
+
+	EGLBoolean result = EGL_TRUE;
+	EGLBoolean presented = EGL_FALSE;
+
+	walkerSurface = walkerDpy->rootSurface;
+
+	while (walkerSurface)
+	{
+		if (_eglInternalIsSwapGroupMember(walkerSurface, swapGroup) && walkerSurface->swapGroupPending)
+		{
+			if (!_eglInternalPresent(walkerDpy, walkerSurface))
 			{
-				case EGL_ALPHA_SIZE:
-				{
+				result = EGL_FALSE;
+			}
+
+			walkerSurface->swapGroupPending = EGL_FALSE;
+
+			presented = EGL_TRUE;
+		}
+
+		walkerSurface = walkerSurface->next;
+	}
+
+	// All frames of the group reach the window system together.
+	if (presented)
+	{
+		__flushSwaps(walkerDpy);
+	}
+
+	return result;
+}
+
+static void _eglInternalLeaveSwapGroup(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLint swapGroup = walkerSurface->swapGroup;
+
+	if (swapGroup == 0)
+	{
+		return;
+	}
+
+	walkerSurface->swapGroup = 0;
+
+	// A held frame is not lost, but presented on its own.
+	if (walkerSurface->swapGroupPending)
+	{
+		walkerSurface->swapGroupPending = EGL_FALSE;
+
+		if (!walkerSurface->destroy)
+		{
+			_eglInternalPresent(walkerDpy, walkerSurface);
+
+			__flushSwaps(walkerDpy);
+		}
+	}
+
+	// The remaining members may now be complete.
+	_eglInternalPresentSwapGroup(walkerDpy, swapGroup);
+}
+
+static EGLBoolean _eglInternalSwapBuffers(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// Pixels of a locked surface are owned by the CPU.
+	if (walkerSurface->surfaceLock.locked)
+	{
+		g_localStorage.error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	// Content of the back buffer is only defined before the swap.
+	if (walkerSurface->exportFrames)
+	{
+		_eglInternalExportFrame(walkerDpy, walkerSurface);
+	}
+
+	if (walkerSurface->frameRing.header)
+	{
+		_eglInternalWriteFrameRing(walkerDpy, walkerSurface);
+	}
+
+	// Swapping has no effect on pixmaps and pbuffers, but rendering to them is limited as well.
+	if (!walkerSurface->drawToWindow)
+	{
+		_eglInternalLimitFramesInFlight(walkerDpy, walkerSurface);
+
+		return EGL_TRUE;
+	}
+
+	if (walkerSurface->timestamps)
+	{
+		_eglInternalRecordFrameTimestamps(walkerDpy, walkerSurface);
+	}
+
+	EGLBoolean result;
+
+	// Rendering to the front buffer is already visible and only has to be flushed.
+	if (walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_SINGLE_BUFFER)
+	{
+		if (_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+		{
+			glFlush();
+		}
+
+		result = EGL_TRUE;
+
+		_eglInternalEndFrame(walkerSurface);
+	}
+	else if (walkerSurface->swapGroup > 0)
+	{
+		// Rendering is submitted now, but the frame is presented together with the other members.
+		if (_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+		{
+			glFlush();
+		}
+
+		walkerSurface->swapGroupPending = EGL_TRUE;
+
+		result = _eglInternalPresentSwapGroup(walkerDpy, walkerSurface->swapGroup);
+	}
+	else
+	{
+		result = _eglInternalPresent(walkerDpy, walkerSurface);
+	}
+
+	if (walkerSurface->timestamps)
+	{
+		_eglInternalUpdateFrameTimestamps(walkerDpy, walkerSurface);
+	}
+
+	if (result)
+	{
+		if (walkerSurface->mutableRenderBuffer)
+		{
+			_eglInternalApplyRenderBuffer(walkerDpy, walkerSurface);
+		}
+
+		_eglInternalLimitFramesInFlight(walkerDpy, walkerSurface);
+	}
+
+	return result;
+}
+
+static EGLBoolean _eglInternalSwapBuffersWithDamage(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+	if (n_rects < 0 || (n_rects > 0 && !rects))
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	// Given damage replaces the damage region of the frame. No rectangles means, that the whole surface is damaged.
+	if (walkerSurface->drawToWindow && !walkerSurface->surfaceLock.locked)
+	{
+		if (n_rects > 0)
+		{
+			__updateSurfaceSize(walkerDpy, walkerSurface);
+
+			walkerSurface->damageRectsCount = _eglInternalMergeDamage(walkerSurface->damageRects, rects, n_rects, walkerSurface->width, walkerSurface->height);
+			walkerSurface->damageRegionSet = EGL_TRUE;
+		}
+		else
+		{
+			walkerSurface->damageRegionSet = EGL_FALSE;
+			walkerSurface->damageRectsCount = 0;
+		}
+	}
+
+	// Frames with damage are exported, held by swap groups and limited like any other frame.
+	return _eglInternalSwapBuffers(walkerDpy, walkerSurface);
+}
+
+static EGLBoolean _eglInternalIsTrusted(const EGLDisplayImpl* walkerDpy)
+{
+#if defined(EGL_DEBUG)
+	// Debug builds always validate the handles.
+	(void)walkerDpy;
+
+	return EGL_FALSE;
+#elif defined(EGL_NO_VALIDATION)
+	(void)walkerDpy;
+
+	return EGL_TRUE;
+#else
+	return walkerDpy->noValidation;
+#endif
+}
+
+static void _eglInternalSetDontCareConfig(EGLConfigImpl* config)
+{
+	if (!config)
+	{
+		return;
+	}
+
+	config->alphaSize = EGL_DONT_CARE;
+	config->alphaMaskSize = EGL_DONT_CARE;
+
+	config->bindToTextureRGB = EGL_DONT_CARE;
+	config->bindToTextureRGBA = EGL_DONT_CARE;
+	config->blueSize = EGL_DONT_CARE;
+	config->bufferSize = EGL_DONT_CARE;
+
+	config->colorBufferType = EGL_DONT_CARE;
+	config->configCaveat = EGL_DONT_CARE;
+	config->configId = EGL_DONT_CARE;
+	config->conformant = EGL_DONT_CARE;
+
+	config->depthSize = EGL_DONT_CARE;
+
+	config->greenSize = EGL_DONT_CARE;
+
+	config->level = EGL_DONT_CARE;
+	config->luminanceSize = EGL_DONT_CARE;
+
+	config->matchFormat = EGL_DONT_CARE;
+	config->matchNativePixmap = EGL_DONT_CARE;
+	config->maxPBufferHeight = EGL_DONT_CARE;
+	config->maxPBufferPixels = EGL_DONT_CARE;
+	config->maxPBufferWidth = EGL_DONT_CARE;
+	config->maxSwapInterval = EGL_DONT_CARE;
+	config->minSwapInterval = EGL_DONT_CARE;
+
+	config->nativeRenderable = EGL_DONT_CARE;
+	config->nativeVisualId = EGL_DONT_CARE;
+	config->nativeVisualType = EGL_DONT_CARE;
+
+	config->redSize = EGL_DONT_CARE;
+	config->renderableType = EGL_DONT_CARE;
+
+	config->sampleBuffers = EGL_DONT_CARE;
+	config->samples = EGL_DONT_CARE;
+	config->stencilSize = EGL_DONT_CARE;
+	config->surfaceType = EGL_DONT_CARE;
+
+	config->transparentBlueValue = EGL_DONT_CARE;
+	config->transparentGreenValue = EGL_DONT_CARE;
+	config->transparentRedValue = EGL_DONT_CARE;
+	config->transparentType = EGL_DONT_CARE;
+
+	// Following parameters always do care.
+
+	config->drawToWindow = EGL_TRUE;
+	config->drawToPixmap = EGL_DONT_CARE;
+	config->drawToPBuffer = EGL_DONT_CARE;
+
+	config->doubleBuffer = EGL_TRUE;
+
+	config->next = 0;
+}
+
+static void _eglInternalSetDefaultSurface(EGLSurfaceImpl* surface)
+{
+	if (!surface)
+	{
+		return;
+	}
+
+	surface->initialized = EGL_FALSE;
+	surface->destroy = EGL_FALSE;
+
+	surface->drawToWindow = EGL_FALSE;
+	surface->drawToPixmap = EGL_FALSE;
+	surface->drawToPBuffer = EGL_FALSE;
+	surface->doubleBuffer = EGL_FALSE;
+	surface->configId = 0;
+
+	surface->mutableRenderBuffer = EGL_FALSE;
+	surface->renderBuffer = EGL_BACK_BUFFER;
+	surface->requestedRenderBuffer = EGL_BACK_BUFFER;
+
+	surface->width = 0;
+	surface->height = 0;
+
+	surface->swapBehavior = EGL_BUFFER_DESTROYED;
+	surface->multisampleResolve = EGL_MULTISAMPLE_RESOLVE_DEFAULT;
+	surface->mipmapLevel = 0;
+	surface->swapInterval = 1;
+	surface->presentationTime = 0;
+
+	surface->presentQueueDepth = 0;
+
+	surface->maxFramesInFlight = 0;
+	surface->frameFencesFirst = 0;
+	surface->frameFencesCount = 0;
+	surface->frameFencesCtx = EGL_NO_CONTEXT;
+
+	surface->timestamps = EGL_FALSE;
+	memset(surface->frameTimestamps, 0, sizeof(surface->frameTimestamps));
+	surface->nextFrameId = 0;
+	surface->nextPresentCounter = 0;
+	surface->presentCounterKnown = EGL_FALSE;
+	surface->timestampsCtx = EGL_NO_CONTEXT;
+
+	surface->swapGroup = 0;
+	surface->swapGroupPending = EGL_FALSE;
+
+	surface->exportFrames = EGL_FALSE;
+	surface->exportFormat = EGL_FRAME_EXPORT_RGBA_DESKTOP;
+	memset(&surface->frameExport, 0, sizeof(EGLFrameExportImpl));
+	surface->frameExport.mapped = -1;
+
+	memset(&surface->frameRing, 0, sizeof(EGLFrameRingImpl));
+	surface->frameRing.fd = -1;
+
+	memset(&surface->surfaceLock, 0, sizeof(EGLSurfaceLockImpl));
+	surface->surfaceLock.dirty = EGL_TRUE;
+
+	surface->bufferAge = 0;
+	surface->bufferAgeQueried = EGL_FALSE;
+
+	surface->damageRegionSet = EGL_FALSE;
+	surface->damageRectsCount = 0;
+
+	surface->textureFormat = EGL_NO_TEXTURE;
+	surface->textureTarget = EGL_NO_TEXTURE;
+	surface->mipmapTexture = EGL_FALSE;
+	surface->largestPBuffer = EGL_FALSE;
+	surface->textureBound = EGL_FALSE;
+
+	surface->win = 0;
+	surface->pixmap = 0;
+
+	memset(&surface->nativeSurfaceContainer, 0, sizeof(NativeSurfaceContainer));
+
+	surface->next = 0;
+}
+
+//
+// EGL_VERSION_1_0
+//
+
+EGLBoolean _eglChooseConfig(EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config)
+{
+	if (!attrib_list)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!configs)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (config_size == 0)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!num_config)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLint attribListIndex = 0;
+
+			EGLConfigImpl config;
+
+			_eglInternalSetDontCareConfig(&config);
+
+			while (attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				switch (attrib_list[attribListIndex])
+				{
+					case EGL_ALPHA_MASK_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.alphaMaskSize = value;
+					}
+					break;
+					case EGL_ALPHA_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.alphaSize = value;
+					}
+					break;
+					case EGL_BIND_TO_TEXTURE_RGB:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.bindToTextureRGB = value;
+					}
+					break;
+					case EGL_BIND_TO_TEXTURE_RGBA:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.bindToTextureRGBA = value;
+					}
+					break;
+					case EGL_BLUE_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.blueSize = value;
+					}
+					break;
+					case EGL_BUFFER_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.bufferSize = value;
+					}
+					break;
+					case EGL_COLOR_BUFFER_TYPE:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_RGB_BUFFER && value != EGL_LUMINANCE_BUFFER)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.colorBufferType = value;
+					}
+					break;
+					case EGL_CONFIG_CAVEAT:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_SLOW_CONFIG && value != EGL_NON_CONFORMANT_CONFIG)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.configCaveat = value;
+					}
+					break;
+					case EGL_CONFIG_ID:
+					{
+						config.configId = value;
+					}
+					break;
+					case EGL_CONFORMANT:
+					{
+						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.conformant = value;
+					}
+					break;
+					case EGL_DEPTH_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.depthSize = value;
+					}
+					break;
+					case EGL_GREEN_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.greenSize = value;
+					}
+					break;
+					case EGL_LEVEL:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.level = value;
+					}
+					break;
+					case EGL_LUMINANCE_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.luminanceSize = value;
+					}
+					break;
+					case EGL_MATCH_FORMAT_KHR:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_FORMAT_RGB_565_EXACT_KHR && value != EGL_FORMAT_RGB_565_KHR && value != EGL_FORMAT_RGBA_8888_EXACT_KHR && value != EGL_FORMAT_RGBA_8888_KHR)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.matchFormat = value;
+					}
+					break;
+					case EGL_MATCH_NATIVE_PIXMAP:
+					{
+						config.matchNativePixmap = value;
+					}
+					break;
+					case EGL_NATIVE_RENDERABLE:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.nativeRenderable = value;
+					}
+					break;
+					case EGL_MAX_SWAP_INTERVAL:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.maxSwapInterval = value;
+					}
+					break;
+					case EGL_MIN_SWAP_INTERVAL:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.minSwapInterval = value;
+					}
+					break;
+					case EGL_RED_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.redSize = value;
+					}
+					break;
+					case EGL_SAMPLE_BUFFERS:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.sampleBuffers = value;
+					}
+					break;
+					case EGL_SAMPLES:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.samples = value;
+					}
+					break;
+					case EGL_STENCIL_SIZE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.stencilSize = value;
+					}
+					break;
+					case EGL_RENDERABLE_TYPE:
+					{
+						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.renderableType = value;
+					}
+					break;
+					case EGL_SURFACE_TYPE:
+					{
+						if (value != EGL_DONT_CARE && value & ~(EGL_MULTISAMPLE_RESOLVE_BOX_BIT | EGL_PBUFFER_BIT | EGL_PIXMAP_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT | EGL_VG_ALPHA_FORMAT_PRE_BIT | EGL_VG_COLORSPACE_LINEAR_BIT | EGL_WINDOW_BIT | EGL_MUTABLE_RENDER_BUFFER_BIT_KHR | EGL_LOCK_SURFACE_BIT_KHR | EGL_OPTIMAL_FORMAT_BIT_KHR))
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.surfaceType = value;
+					}
+					break;
+					case EGL_TRANSPARENT_TYPE:
+					{
+						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_TRANSPARENT_TYPE)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.transparentType = value;
+					}
+					break;
+					case EGL_TRANSPARENT_RED_VALUE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.transparentRedValue = value;
+					}
+					break;
+					case EGL_TRANSPARENT_GREEN_VALUE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.transparentGreenValue = value;
+					}
+					break;
+					case EGL_TRANSPARENT_BLUE_VALUE:
+					{
+						if (value != EGL_DONT_CARE && value < 0)
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+
+						config.transparentBlueValue = value;
+					}
+					break;
+					default:
+					{
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_FALSE;
+					}
+					break;
+				}
+
+				attribListIndex += 2;
+
+				// More than 28 entries can not exist.
+				if (attribListIndex >= 28 * 2)
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+
+			// Check, if this configuration exists.
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			EGLint configIndex = 0;
+
+			while (walkerConfig && configIndex < config_size)
+			{
+				if (config.alphaMaskSize != EGL_DONT_CARE && config.alphaMaskSize != walkerConfig->alphaMaskSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.alphaSize != EGL_DONT_CARE && config.alphaSize != walkerConfig->alphaSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.bindToTextureRGB != EGL_DONT_CARE && config.bindToTextureRGB != walkerConfig->bindToTextureRGB)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.bindToTextureRGBA != EGL_DONT_CARE && config.bindToTextureRGBA != walkerConfig->bindToTextureRGBA)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.blueSize != EGL_DONT_CARE && config.blueSize != walkerConfig->blueSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.bufferSize != EGL_DONT_CARE && config.bufferSize != walkerConfig->bufferSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.colorBufferType != EGL_DONT_CARE && config.colorBufferType != walkerConfig->colorBufferType)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.configCaveat != EGL_DONT_CARE && config.configCaveat != walkerConfig->configCaveat)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.configId != EGL_DONT_CARE && config.configId != walkerConfig->configId)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.conformant != EGL_DONT_CARE && config.conformant != walkerConfig->conformant)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.depthSize != EGL_DONT_CARE && config.depthSize != walkerConfig->depthSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.greenSize != EGL_DONT_CARE && config.greenSize != walkerConfig->greenSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.level != EGL_DONT_CARE && config.level != walkerConfig->level)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.luminanceSize != EGL_DONT_CARE && config.luminanceSize != walkerConfig->luminanceSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				// Exact formats need no conversion, so they also match the converted format.
+				if (config.matchFormat != EGL_DONT_CARE && config.matchFormat != walkerConfig->matchFormat && !(config.matchFormat == EGL_FORMAT_RGBA_8888_KHR && walkerConfig->matchFormat == EGL_FORMAT_RGBA_8888_EXACT_KHR))
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.matchNativePixmap != EGL_DONT_CARE && config.matchNativePixmap != walkerConfig->matchNativePixmap)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.nativeRenderable != EGL_DONT_CARE && config.nativeRenderable != walkerConfig->nativeRenderable)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.maxSwapInterval != EGL_DONT_CARE && config.maxSwapInterval != walkerConfig->maxSwapInterval)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.minSwapInterval != EGL_DONT_CARE && config.minSwapInterval != walkerConfig->minSwapInterval)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.redSize != EGL_DONT_CARE && config.redSize != walkerConfig->redSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.sampleBuffers != EGL_DONT_CARE && config.sampleBuffers != walkerConfig->sampleBuffers)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.samples != EGL_DONT_CARE && config.samples != walkerConfig->samples)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.stencilSize != EGL_DONT_CARE && config.stencilSize != walkerConfig->stencilSize)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.renderableType != EGL_DONT_CARE && config.renderableType != walkerConfig->renderableType)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.surfaceType != EGL_DONT_CARE && !(config.surfaceType & walkerConfig->surfaceType))
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.transparentType != EGL_DONT_CARE && config.transparentType != walkerConfig->transparentType)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.transparentRedValue != EGL_DONT_CARE && config.transparentRedValue != walkerConfig->transparentRedValue)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.transparentGreenValue != EGL_DONT_CARE && config.transparentGreenValue != walkerConfig->transparentGreenValue)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+				if (config.transparentBlueValue != EGL_DONT_CARE && config.transparentBlueValue != walkerConfig->transparentBlueValue)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+
+				//
+
+				if (config.drawToWindow != EGL_DONT_CARE && config.drawToWindow != walkerConfig->drawToWindow)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+
+				if (config.drawToPixmap != EGL_DONT_CARE && config.drawToPixmap != walkerConfig->drawToPixmap)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+
+				if (config.drawToPBuffer != EGL_DONT_CARE && config.drawToPBuffer != walkerConfig->drawToPBuffer)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+
+				if (config.doubleBuffer != EGL_DONT_CARE && config.doubleBuffer != walkerConfig->doubleBuffer)
+				{
+					walkerConfig = walkerConfig->next;
+
+					continue;
+				}
+
+				//
+
+				configs[configIndex] = walkerConfig;
+
+				walkerConfig = walkerConfig->next;
+
+				configIndex++;
+			}
+
+			*num_config = configIndex;
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglCopyBuffers(EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					// The color buffer is read back by the current context.
+					if (walkerDpy->currentCtx != g_localStorage.currentCtx || walkerDpy->currentDraw != walkerSurface)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (!target)
+					{
+						g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+
+						return EGL_FALSE;
+					}
+
+					return __copyBuffers(walkerDpy, walkerSurface, target, &g_localStorage.error);
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
+{
+	if (!attrib_list)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (g_localStorage.api == EGL_NONE)
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_NO_CONTEXT;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLint target_attrib_list[CONTEXT_ATTRIB_LIST_SIZE];
+
+					if (!__processAttribList(target_attrib_list, attrib_list, walkerDpy, &g_localStorage.error))
+					{
+						return EGL_FALSE;
+					}
+
+					EGLContextImpl* sharedCtx = 0;
+
+					if (share_context != EGL_NO_CONTEXT)
+					{
+						EGLDisplayImpl* sharedWalkerDpy = g_localStorage.rootDpy;
+
+						while (sharedWalkerDpy)
+						{
+							EGLContextImpl* sharedWalkerCtx = sharedWalkerDpy->rootCtx;
+
+							while (sharedWalkerCtx)
+							{
+								if ((EGLContext)sharedWalkerCtx == share_context)
+								{
+									if (!sharedWalkerCtx->initialized || sharedWalkerCtx->destroy)
+									{
+										g_localStorage.error = EGL_BAD_CONTEXT;
+
+										return EGL_FALSE;
+									}
+
+									sharedCtx = sharedWalkerCtx;
+
+									break;
+								}
+
+								sharedWalkerCtx = sharedWalkerCtx->next;
+							}
+
+							sharedWalkerDpy = sharedWalkerDpy->next;
+						}
+
+						if (!sharedCtx)
+						{
+							g_localStorage.error = EGL_BAD_CONTEXT;
+
+							return EGL_FALSE;
+						}
+					}
+
+					EGLContextImpl* newCtx = (EGLContextImpl*)malloc(sizeof(EGLContextImpl));
+
+					if (!newCtx)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_FALSE;
+					}
+
+					// Move the atttibutes for later creation.
+					memcpy(newCtx->attribList, target_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+
+					newCtx->initialized = EGL_TRUE;
+					newCtx->destroy = EGL_FALSE;
+					newCtx->configId = walkerConfig->configId;
+					newCtx->sharedCtx = sharedCtx;
+					newCtx->rootCtxList = 0;
+
+					// The requested priority is validated by the platform, but can not be passed natively. So it is kept as a hint.
+					newCtx->priority = EGL_CONTEXT_PRIORITY_MEDIUM_IMG;
+
+					EGLint attribListIndex = 0;
+
+					while (attrib_list[attribListIndex] != EGL_NONE)
+					{
+						if (attrib_list[attribListIndex] == EGL_CONTEXT_PRIORITY_LEVEL_IMG)
+						{
+							newCtx->priority = attrib_list[attribListIndex + 1];
+						}
+
+						attribListIndex += 2;
+					}
+
+					newCtx->next = walkerDpy->rootCtx;
+					walkerDpy->rootCtx = newCtx;
+
+					return (EGLContext)newCtx;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_CONTEXT;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_CONTEXT;
+}
+
+EGLSurface _eglCreateWindowSurface(EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+					_eglInternalSetDefaultSurface(newSurface);
+
+					if (!__createWindowSurface(newSurface, win, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						return EGL_NO_SURFACE;
+					}
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLSurface _eglCreatePixmapSurface(EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					if (!walkerConfig->drawToPixmap)
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_NO_SURFACE;
+					}
+
+					if (!pixmap)
+					{
+						g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+
+						return EGL_NO_SURFACE;
+					}
+
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+					_eglInternalSetDefaultSurface(newSurface);
+
+					if (!__createPixmapSurface(newSurface, pixmap, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						return EGL_NO_SURFACE;
+					}
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLSurface _eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLint *attrib_list)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					if (!walkerConfig->drawToPBuffer)
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_NO_SURFACE;
+					}
+
+					EGLint width = 0;
+					EGLint height = 0;
+					EGLint textureFormat = EGL_NO_TEXTURE;
+					EGLint textureTarget = EGL_NO_TEXTURE;
+					EGLBoolean mipmapTexture = EGL_FALSE;
+					EGLBoolean largestPBuffer = EGL_FALSE;
+
+					if (attrib_list)
+					{
+						EGLint indexAttribList = 0;
+
+						while (attrib_list[indexAttribList] != EGL_NONE)
+						{
+							EGLint value = attrib_list[indexAttribList + 1];
+
+							switch (attrib_list[indexAttribList])
+							{
+								case EGL_WIDTH:
+								{
+									if (value < 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
+
+										return EGL_NO_SURFACE;
+									}
+
+									width = value;
+								}
+								break;
+								case EGL_HEIGHT:
+								{
+									if (value < 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
+
+										return EGL_NO_SURFACE;
+									}
+
+									height = value;
+								}
+								break;
+								case EGL_LARGEST_PBUFFER:
+								{
+									largestPBuffer = value ? EGL_TRUE : EGL_FALSE;
+								}
+								break;
+								case EGL_TEXTURE_FORMAT:
+								{
+									if (value == EGL_TEXTURE_RGB)
+									{
+										if (walkerConfig->bindToTextureRGB != EGL_TRUE)
+										{
+											g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+											return EGL_NO_SURFACE;
+										}
+									}
+									else if (value == EGL_TEXTURE_RGBA)
+									{
+										if (walkerConfig->bindToTextureRGBA != EGL_TRUE)
+										{
+											g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+											return EGL_NO_SURFACE;
+										}
+									}
+									else if (value != EGL_NO_TEXTURE)
+									{
+										g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+										return EGL_NO_SURFACE;
+									}
+
+									textureFormat = value;
+								}
+								break;
+								case EGL_TEXTURE_TARGET:
+								{
+									if (value != EGL_TEXTURE_2D && value != EGL_NO_TEXTURE)
+									{
+										g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+										return EGL_NO_SURFACE;
+									}
+
+									textureTarget = value;
+								}
+								break;
+								case EGL_MIPMAP_TEXTURE:
+								{
+									mipmapTexture = value ? EGL_TRUE : EGL_FALSE;
+								}
+								break;
+								case EGL_GL_COLORSPACE:
+								{
+									if (value == EGL_GL_COLORSPACE_LINEAR)
+									{
+										// Do nothing.
+									}
+									else if (value == EGL_GL_COLORSPACE_SRGB)
+									{
+										g_localStorage.error = EGL_BAD_MATCH;
+
+										return EGL_NO_SURFACE;
+									}
+									else
+									{
+										g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+										return EGL_NO_SURFACE;
+									}
+								}
+								break;
+								case EGL_VG_ALPHA_FORMAT:
+								case EGL_VG_COLORSPACE:
+								{
+									g_localStorage.error = EGL_BAD_MATCH;
+
+									return EGL_NO_SURFACE;
+								}
+								break;
+								default:
+								{
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+								break;
+							}
+
+							indexAttribList += 2;
+
+							// More than 9 entries can not exist.
+							if (indexAttribList >= 9 * 2)
+							{
+								g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+								return EGL_NO_SURFACE;
+							}
+						}
+					}
+
+					// Either both or none of the texture attributes have to be set.
+					if ((textureFormat == EGL_NO_TEXTURE) != (textureTarget == EGL_NO_TEXTURE))
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_NO_SURFACE;
+					}
+
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+					_eglInternalSetDefaultSurface(newSurface);
+
+					newSurface->width = width;
+					newSurface->height = height;
+					newSurface->textureFormat = textureFormat;
+					newSurface->textureTarget = textureTarget;
+					newSurface->mipmapTexture = mipmapTexture;
+					newSurface->largestPBuffer = largestPBuffer;
+
+					if (!__createPbufferSurface(newSurface, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						return EGL_NO_SURFACE;
+					}
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLBoolean _eglDestroyContext(EGLDisplay dpy, EGLContext ctx)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+			while (walkerCtx)
+			{
+				if ((EGLContext)walkerCtx == ctx)
+				{
+					if (!walkerCtx->initialized || walkerCtx->destroy)
+					{
+						g_localStorage.error = EGL_BAD_CONTEXT;
+
+						return EGL_FALSE;
+					}
+
+					walkerCtx->initialized = EGL_FALSE;
+					walkerCtx->destroy = EGL_TRUE;
+
+					_eglInternalCleanup();
+
+					return EGL_TRUE;
+				}
+
+				walkerCtx = walkerCtx->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONTEXT;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglDestroySurface(EGLDisplay dpy, EGLSurface surface)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					walkerSurface->initialized = EGL_FALSE;
+					walkerSurface->destroy = EGL_TRUE;
+
+					_eglInternalLeaveSwapGroup(walkerDpy, walkerSurface);
+
+					if (walkerSurface->exportFrames)
+					{
+						_eglInternalReleaseFrameExport(walkerDpy, walkerSurface);
+					}
+
+					_eglInternalReleaseFrameRing(walkerDpy, walkerSurface);
+
+					_eglInternalReleaseFramesInFlight(walkerDpy, walkerSurface);
+
+					_eglInternalReleaseSurfaceLock(walkerDpy, walkerSurface);
+
+					if (walkerSurface->textureBound)
+					{
+						__releaseTexImage(walkerDpy, walkerSurface);
+
+						walkerSurface->textureBound = EGL_FALSE;
+					}
+
+					__destroySurface(walkerDpy, walkerSurface);
+
+					_eglInternalCleanup();
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint *value)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					break;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			if (!walkerConfig)
+			{
+				g_localStorage.error = EGL_BAD_CONFIG;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_ALPHA_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->alphaSize;
+					}
+				}
+				break;
+				case EGL_ALPHA_MASK_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->alphaMaskSize;
+					}
+				}
+				break;
+				case EGL_BIND_TO_TEXTURE_RGB:
+				{
+					if (value)
+					{
+						*value = walkerConfig->bindToTextureRGB;
+					}
+				}
+				break;
+				case EGL_BIND_TO_TEXTURE_RGBA:
+				{
+					if (value)
+					{
+						*value = walkerConfig->bindToTextureRGBA;
+					}
+				}
+				break;
+				case EGL_BLUE_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->blueSize;
+					}
+				}
+				break;
+				case EGL_BUFFER_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->bufferSize;
+					}
+				}
+				break;
+				case EGL_COLOR_BUFFER_TYPE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->colorBufferType;
+					}
+				}
+				break;
+				case EGL_CONFIG_CAVEAT:
+				{
+					if (value)
+					{
+						*value = walkerConfig->configCaveat;
+					}
+				}
+				break;
+				case EGL_CONFIG_ID:
+				{
+					if (value)
+					{
+						*value = walkerConfig->configId;
+					}
+				}
+				break;
+				case EGL_CONFORMANT:
+				{
+					if (value)
+					{
+						*value = walkerConfig->conformant;
+					}
+				}
+				break;
+				case EGL_DEPTH_SIZE:
+				{
 					if (value)
 					{
-						*value = walkerConfig->alphaSize;
+						*value = walkerConfig->depthSize;
+					}
+				}
+				break;
+				case EGL_GREEN_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->greenSize;
+					}
+				}
+				break;
+				case EGL_LEVEL:
+				{
+					if (value)
+					{
+						*value = walkerConfig->level;
+					}
+				}
+				break;
+				case EGL_LUMINANCE_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->luminanceSize;
+					}
+				}
+				break;
+				case EGL_MATCH_FORMAT_KHR:
+				{
+					if (value)
+					{
+						*value = walkerConfig->matchFormat;
+					}
+				}
+				break;
+				case EGL_MAX_PBUFFER_WIDTH:
+				{
+					if (value)
+					{
+						*value = walkerConfig->maxPBufferWidth;
+					}
+				}
+				break;
+				case EGL_MAX_PBUFFER_HEIGHT:
+				{
+					if (value)
+					{
+						*value = walkerConfig->maxPBufferHeight;
+					}
+				}
+				break;
+				case EGL_MAX_PBUFFER_PIXELS:
+				{
+					if (value)
+					{
+						*value = walkerConfig->maxPBufferPixels;
+					}
+				}
+				break;
+				case EGL_MAX_SWAP_INTERVAL:
+				{
+					if (value)
+					{
+						*value = walkerConfig->maxSwapInterval;
+					}
+				}
+				break;
+				case EGL_MIN_SWAP_INTERVAL:
+				{
+					if (value)
+					{
+						*value = walkerConfig->minSwapInterval;
+					}
+				}
+				break;
+				case EGL_NATIVE_RENDERABLE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->nativeRenderable;
+					}
+				}
+				break;
+				case EGL_NATIVE_VISUAL_ID:
+				{
+					if (value)
+					{
+						*value = walkerConfig->nativeVisualId;
+					}
+				}
+				break;
+				case EGL_NATIVE_VISUAL_TYPE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->nativeVisualType;
+					}
+				}
+				break;
+				case EGL_RED_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->redSize;
+					}
+				}
+				break;
+				case EGL_RENDERABLE_TYPE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->renderableType;
+					}
+				}
+				break;
+				case EGL_SAMPLE_BUFFERS:
+				{
+					if (value)
+					{
+						*value = walkerConfig->sampleBuffers;
+					}
+				}
+				break;
+				case EGL_SAMPLES:
+				{
+					if (value)
+					{
+						*value = walkerConfig->samples;
+					}
+				}
+				break;
+				case EGL_STENCIL_SIZE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->stencilSize;
+					}
+				}
+				break;
+				case EGL_SURFACE_TYPE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->surfaceType;
+					}
+				}
+				break;
+				case EGL_TRANSPARENT_TYPE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->transparentType;
+					}
+				}
+				break;
+				case EGL_TRANSPARENT_RED_VALUE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->transparentRedValue;
+					}
+				}
+				break;
+				case EGL_TRANSPARENT_GREEN_VALUE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->transparentGreenValue;
+					}
+				}
+				break;
+				case EGL_TRANSPARENT_BLUE_VALUE:
+				{
+					if (value)
+					{
+						*value = walkerConfig->transparentBlueValue;
+					}
+				}
+				break;
+				default:
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size, EGLint *num_config)
+{
+	if (!configs)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (config_size == 0)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!num_config)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			EGLint configIndex = 0;
+
+			while (walkerConfig && configIndex < config_size)
+			{
+				configs[configIndex] = walkerConfig;
+
+				walkerConfig = walkerConfig->next;
+
+				configIndex++;
+			}
+
+			*num_config = configIndex;
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLDisplay _eglGetCurrentDisplay(void)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			return (EGLDisplay)walkerDpy;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	return EGL_NO_DISPLAY;
+}
+
+EGLSurface _eglGetCurrentSurface(EGLint readdraw)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_NO_SURFACE;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			if (readdraw == EGL_DRAW)
+			{
+				return (EGLSurface)walkerDpy->currentDraw;
+			}
+			else if (readdraw == EGL_READ)
+			{
+				return (EGLSurface)walkerDpy->currentRead;
+			}
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	return EGL_NO_SURFACE;
+}
+
+EGLDisplay _eglGetDisplay(EGLNativeDisplayType display_id)
+{
+	if (!_eglInternalInit())
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	//
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->display_id == display_id)
+		{
+			return (EGLDisplay)walkerDpy;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	EGLDisplayImpl* newDpy = (EGLDisplayImpl*)malloc(sizeof(EGLDisplayImpl));
+
+	if (!newDpy)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	newDpy->initialized = EGL_FALSE;
+	newDpy->destroy = EGL_FALSE;
+#if defined(_WIN32) || defined(_WIN64)
+	newDpy->display_id = display_id ? display_id : g_localStorage.dummy.hdc;
+#else
+	newDpy->display_id = display_id ? display_id : g_localStorage.dummy.display;
+#endif
+	memset(&newDpy->nativeDisplayContainer, 0, sizeof(NativeDisplayContainer));
+	newDpy->extensions[0] = '\0';
+	newDpy->rootSurface = 0;
+	newDpy->rootCtx = 0;
+	newDpy->rootConfig = 0;
+	newDpy->rootImage = 0;
+	newDpy->currentDraw = EGL_NO_SURFACE;
+	newDpy->currentRead = EGL_NO_SURFACE;
+	newDpy->currentCtx = EGL_NO_CONTEXT;
+	newDpy->noValidation = EGL_FALSE;
+	newDpy->makeCurrentCalls = 0;
+	newDpy->makeCurrentSkipped = 0;
+	newDpy->next = g_localStorage.rootDpy;
+
+	g_localStorage.rootDpy = newDpy;
+
+	return newDpy;
+}
+
+EGLint _eglGetError(void)
+{
+	EGLint currentError = g_localStorage.error;
+
+	g_localStorage.error = EGL_SUCCESS;
+
+	return currentError;
+}
+
+__eglMustCastToProperFunctionPointerType _eglGetProcAddress(const char *procname)
+{
+	if (!procname)
+	{
+		return 0;
+	}
+
+	// Extension functions implemented by this library are not known by the native platform.
+	EGLint procAddressIndex = 0;
+
+	while (g_procAddresses[procAddressIndex].procname)
+	{
+		if (strcmp(g_procAddresses[procAddressIndex].procname, procname) == 0)
+		{
+			return g_procAddresses[procAddressIndex].address;
+		}
+
+		procAddressIndex++;
+	}
+
+	return __getProcAddress(procname);
+}
+
+EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			walkerDpy->extensions[0] = '\0';
+
+			if (!__initialize(walkerDpy, &g_localStorage.dummy, &g_localStorage.error))
+			{
+				return EGL_FALSE;
+			}
+
+			// Implemented on top of the platform swap.
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_swap_buffers_with_damage");
+			_eglInternalAddExtension(walkerDpy, "EGL_EXT_swap_buffers_with_damage");
+			_eglInternalAddExtension(walkerDpy, "EGL_EXT_buffer_age");
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_partial_update");
+			_eglInternalAddExtension(walkerDpy, "EGL_IMG_context_priority");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_display_statistics");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_frames_in_flight");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_frame_timestamps");
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_mutable_render_buffer");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_swap_group");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_swap_buffers_batch");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_frame_export");
+			_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_frame_export_yuv");
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_lock_surface");
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_lock_surface2");
+			_eglInternalAddExtension(walkerDpy, "EGL_KHR_lock_surface3");
+
+			walkerDpy->initialized = EGL_TRUE;
+
+
+			//
+
+			if (major)
+			{
+				*major = 1;
+			}
+
+			if (minor)
+			{
+				*minor = 5;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	if ((ctx == EGL_NO_CONTEXT && (draw != EGL_NO_SURFACE || read != EGL_NO_SURFACE)) || (ctx != EGL_NO_CONTEXT && (draw == EGL_NO_SURFACE || read == EGL_NO_SURFACE)))
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			walkerDpy->makeCurrentCalls++;
+
+			// Nothing to do, if the same valid binding is already current on this thread.
+			if ((EGLSurface)walkerDpy->currentDraw == draw && (EGLSurface)walkerDpy->currentRead == read && (EGLContext)walkerDpy->currentCtx == ctx && g_localStorage.currentCtx == walkerDpy->currentCtx)
+			{
+				if ((!walkerDpy->currentDraw || (walkerDpy->currentDraw->initialized && !walkerDpy->currentDraw->destroy)) &&
+					(!walkerDpy->currentRead || (walkerDpy->currentRead->initialized && !walkerDpy->currentRead->destroy)) &&
+					(!walkerDpy->currentCtx || (walkerDpy->currentCtx->initialized && !walkerDpy->currentCtx->destroy)))
+				{
+					walkerDpy->makeCurrentSkipped++;
+
+					return EGL_TRUE;
+				}
+			}
+
+			EGLSurfaceImpl* currentDraw = EGL_NO_SURFACE;
+			EGLSurfaceImpl* currentRead = EGL_NO_SURFACE;
+			EGLContextImpl* currentCtx = EGL_NO_CONTEXT;
+
+			NativeSurfaceContainer* nativeSurfaceContainer = 0;
+			NativeContextContainer* nativeContextContainer = 0;
+
+			EGLBoolean result;
+
+			EGLBoolean trusted = _eglInternalIsTrusted(walkerDpy);
+
+			if (trusted)
+			{
+				currentDraw = (EGLSurfaceImpl*)draw;
+				currentRead = (EGLSurfaceImpl*)read;
+				currentCtx = (EGLContextImpl*)ctx;
+			}
+
+			if (!trusted && draw != EGL_NO_SURFACE)
+			{
+				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+				while (walkerSurface)
+				{
+					if ((EGLSurface)walkerSurface == draw)
+					{
+						if (!walkerSurface->initialized || walkerSurface->destroy)
+						{
+							g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
+
+							return EGL_FALSE;
+						}
+
+						currentDraw = walkerSurface;
+
+						break;
+					}
+
+					walkerSurface = walkerSurface->next;
+				}
+
+				if (!currentDraw)
+				{
+					g_localStorage.error = EGL_BAD_SURFACE;
+
+					return EGL_FALSE;
+				}
+			}
+
+			if (!trusted && read != EGL_NO_SURFACE)
+			{
+				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+				while (walkerSurface)
+				{
+					if ((EGLSurface)walkerSurface == read)
+					{
+						if (!walkerSurface->initialized || walkerSurface->destroy)
+						{
+							g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
+
+							return EGL_FALSE;
+						}
+
+						currentRead = walkerSurface;
+
+						break;
 					}
+
+					walkerSurface = walkerSurface->next;
 				}
-				break;
-				case EGL_ALPHA_MASK_SIZE:
+
+				if (!currentRead)
 				{
-					if (value)
+					g_localStorage.error = EGL_BAD_SURFACE;
+
+					return EGL_FALSE;
+				}
+			}
+
+			// Pixels of a locked surface are owned by the CPU.
+			if ((currentDraw && currentDraw->surfaceLock.locked) || (currentRead && currentRead->surfaceLock.locked))
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			if (!trusted && ctx != EGL_NO_CONTEXT)
+			{
+				EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+				while (walkerCtx)
+				{
+					if ((EGLContext)walkerCtx == ctx)
 					{
-						*value = walkerConfig->alphaMaskSize;
+						if (!walkerCtx->initialized || walkerCtx->destroy)
+						{
+							g_localStorage.error = EGL_BAD_CONTEXT;
+
+							return EGL_FALSE;
+						}
+
+						currentCtx = walkerCtx;
+
+						break;
+					}
+
+					walkerCtx = walkerCtx->next;
+				}
+
+				if (!currentCtx)
+				{
+					g_localStorage.error = EGL_BAD_CONTEXT;
+
+					return EGL_FALSE;
+				}
+			}
+
+			if (currentDraw != EGL_NO_SURFACE)
+			{
+				nativeSurfaceContainer = &currentDraw->nativeSurfaceContainer;
+			}
+
+			if (currentCtx != EGL_NO_CONTEXT)
+			{
+				EGLContextListImpl* ctxList = currentCtx->rootCtxList;
+
+				while (ctxList)
+				{
+					if (ctxList->surface == currentDraw)
+					{
+						break;
+					}
+
+					ctxList = ctxList->next;
+				}
+
+				if (!ctxList)
+				{
+					ctxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+
+					if (!ctxList)
+					{
+						return EGL_FALSE;
+					}
+
+					// Gather shared context, if one exists.
+					EGLContextListImpl* sharedCtxList = 0;
+					if (currentCtx->sharedCtx)
+					{
+						EGLContextImpl* sharedWalkerCtx = currentCtx->sharedCtx;
+
+						EGLContextImpl* beforeSharedWalkerCtx = 0;
+
+						while (sharedWalkerCtx)
+						{
+							// Check, if already created.
+							if (sharedWalkerCtx->rootCtxList)
+							{
+								sharedCtxList = sharedWalkerCtx->rootCtxList;
+
+								break;
+							}
+
+							beforeSharedWalkerCtx = sharedWalkerCtx;
+							sharedWalkerCtx = sharedWalkerCtx->sharedCtx;
+
+							// No created shared context found.
+							if (!sharedWalkerCtx)
+							{
+								sharedCtxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+
+								if (!sharedCtxList)
+								{
+									free(ctxList);
+
+									return EGL_FALSE;
+								}
+
+								result = __createContext(&sharedCtxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, 0, beforeSharedWalkerCtx->attribList);
+
+								if (!result)
+								{
+									free(sharedCtxList);
+
+									free(ctxList);
+
+									return EGL_FALSE;
+								}
+
+								sharedCtxList->surface = currentDraw;
+								sharedCtxList->swapInterval = 0;
+								sharedCtxList->swapIntervalApplied = EGL_FALSE;
+								sharedCtxList->renderBufferApplied = EGL_NONE;
+
+								sharedCtxList->next = beforeSharedWalkerCtx->rootCtxList;
+								beforeSharedWalkerCtx->rootCtxList = sharedCtxList;
+							}
+						}
+					}
+					else
+					{
+						// Use own context as shared context, if one exits.
+
+						sharedCtxList = currentCtx->rootCtxList;
+					}
+
+					result = __createContext(&ctxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, sharedCtxList ? &sharedCtxList->nativeContextContainer : 0, currentCtx->attribList);
+
+					if (!result)
+					{
+						free(ctxList);
+
+						return EGL_FALSE;
+					}
+
+					ctxList->surface = currentDraw;
+					ctxList->swapInterval = 0;
+					ctxList->swapIntervalApplied = EGL_FALSE;
+					ctxList->renderBufferApplied = EGL_NONE;
+
+					ctxList->next = currentCtx->rootCtxList;
+					currentCtx->rootCtxList = ctxList;
+				}
+
+				nativeContextContainer = &ctxList->nativeContextContainer;
+			}
+
+			// Fences of frames in flight are deleted, while the context, which did insert them, is still current.
+			if (walkerDpy->currentCtx && walkerDpy->currentCtx != currentCtx && walkerDpy->currentCtx == g_localStorage.currentCtx)
+			{
+				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+				while (walkerSurface)
+				{
+					if (walkerSurface->frameFencesCtx == walkerDpy->currentCtx)
+					{
+						_eglInternalReleaseFramesInFlight(walkerDpy, walkerSurface);
+					}
+
+					walkerSurface = walkerSurface->next;
+				}
+			}
+
+			result = __makeCurrent(walkerDpy, nativeSurfaceContainer, nativeContextContainer);
+
+			if (!result)
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
+
+				return EGL_FALSE;
+			}
+
+			// Destroyed objects, which were current, are freed now. Otherwise, walking all objects is not needed.
+			EGLBoolean cleanup = walkerDpy->destroy || (walkerDpy->currentDraw && walkerDpy->currentDraw->destroy) || (walkerDpy->currentRead && walkerDpy->currentRead->destroy) || (walkerDpy->currentCtx && walkerDpy->currentCtx->destroy) || (g_localStorage.currentCtx && g_localStorage.currentCtx->destroy);
+
+			walkerDpy->currentDraw = currentDraw;
+			walkerDpy->currentRead = currentRead;
+			walkerDpy->currentCtx = currentCtx;
+
+			// The client API may render to the surface, so a later lock has to read back its pixels again.
+			if (currentDraw)
+			{
+				currentDraw->surfaceLock.dirty = EGL_TRUE;
+			}
+
+			g_localStorage.currentCtx = currentCtx;
+
+			// The interval is only set natively on first bind of the window to a context, or if it did change meanwhile.
+			if (currentDraw && currentDraw->drawToWindow)
+			{
+				_eglInternalApplySwapInterval(walkerDpy, currentDraw);
+			}
+
+			// The context may have been bound to the window before its render buffer did change.
+			if (currentDraw && currentDraw->mutableRenderBuffer)
+			{
+				_eglInternalSetDrawBuffer(walkerDpy, currentDraw);
+			}
+
+			if (cleanup)
+			{
+				_eglInternalCleanup();
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint *value)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+			while (walkerCtx)
+			{
+				if ((EGLContext)walkerCtx == ctx)
+				{
+					if (!walkerCtx->initialized || walkerCtx->destroy)
+					{
+						return EGL_FALSE;
+					}
+
+					switch (attribute)
+					{
+						case EGL_CONFIG_ID:
+						{
+							if (value)
+							{
+								*value = walkerCtx->configId;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_CLIENT_TYPE:
+						{
+							if (value)
+							{
+								*value = EGL_OPENGL_API;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+						{
+							if (value)
+							{
+								*value = walkerCtx->priority;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_CLIENT_VERSION:
+						{
+							// Regarding the specification, it only makes sense for OpenGL ES.
+
+							return EGL_FALSE;
+						}
+						break;
+						case EGL_RENDER_BUFFER:
+						{
+							if (walkerDpy->currentCtx == walkerCtx)
+							{
+								EGLSurfaceImpl* currentSurface = walkerDpy->currentDraw ? walkerDpy->currentDraw : walkerDpy->currentRead;
+
+								if (currentSurface)
+								{
+									if (currentSurface->drawToWindow)
+									{
+										if (value)
+										{
+											*value = currentSurface->renderBuffer;
+										}
+
+										return EGL_TRUE;
+									}
+									else if (currentSurface->drawToPixmap)
+									{
+										if (value)
+										{
+											*value = EGL_SINGLE_BUFFER;
+										}
+
+										return EGL_TRUE;
+									}
+									else if (currentSurface->drawToPBuffer)
+									{
+										if (value)
+										{
+											*value = EGL_BACK_BUFFER;
+										}
+
+										return EGL_TRUE;
+									}
+								}
+
+								if (value)
+								{
+									*value = EGL_NONE;
+								}
+
+								return EGL_FALSE;
+							}
+							else
+							{
+								if (value)
+								{
+									*value = EGL_NONE;
+								}
+
+								return EGL_FALSE;
+							}
+						}
+						break;
 					}
+
+					g_localStorage.error = EGL_BAD_PARAMETER;
+
+					return EGL_FALSE;
 				}
-				break;
-				case EGL_BIND_TO_TEXTURE_RGB:
+
+				walkerCtx = walkerCtx->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONTEXT;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+const char *_eglQueryString(EGLDisplay dpy, EGLint name)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return 0;
+			}
+
+			switch (name)
+			{
+				case EGL_CLIENT_APIS:
 				{
-					if (value)
-					{
-						*value = walkerConfig->bindToTextureRGB;
-					}
+					return "EGL_OPENGL_API";
 				}
 				break;
-				case EGL_BIND_TO_TEXTURE_RGBA:
+				case EGL_VENDOR:
 				{
-					if (value)
-					{
-						*value = walkerConfig->bindToTextureRGBA;
-					}
+					return _EGL_VENDOR;
 				}
 				break;
-				case EGL_BLUE_SIZE:
+				case EGL_VERSION:
 				{
-					if (value)
-					{
-						*value = walkerConfig->blueSize;
-					}
+					return _EGL_VERSION;
 				}
 				break;
-				case EGL_BUFFER_SIZE:
+				case EGL_EXTENSIONS:
 				{
-					if (value)
-					{
-						*value = walkerConfig->bufferSize;
-					}
+					return walkerDpy->extensions;
 				}
 				break;
-				case EGL_COLOR_BUFFER_TYPE:
+			}
+
+			g_localStorage.error = EGL_BAD_PARAMETER;
+
+			return 0;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return 0;
+}
+
+EGLBoolean _eglQuerySurface (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint *value)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						*value = walkerConfig->colorBufferType;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_CONFIG_CAVEAT:
-				{
-					if (value)
+
+					switch (attribute)
 					{
-						*value = walkerConfig->configCaveat;
+						case EGL_CONFIG_ID:
+						{
+							if (value)
+							{
+								*value = walkerSurface->configId;
+							}
+						}
+						break;
+						case EGL_GL_COLORSPACE:
+						{
+							// sRGB surfaces are not supported.
+							if (value)
+							{
+								*value = EGL_GL_COLORSPACE_LINEAR;
+							}
+						}
+						break;
+						case EGL_WIDTH:
+						case EGL_HEIGHT:
+						{
+							// Only windows can change their size.
+							if (walkerSurface->drawToWindow)
+							{
+								__updateSurfaceSize(walkerDpy, walkerSurface);
+							}
+
+							if (value)
+							{
+								*value = attribute == EGL_WIDTH ? walkerSurface->width : walkerSurface->height;
+							}
+						}
+						break;
+						case EGL_HORIZONTAL_RESOLUTION:
+						case EGL_VERTICAL_RESOLUTION:
+						{
+							// The dot pitch of the monitor is not reliably known.
+							if (value)
+							{
+								*value = EGL_UNKNOWN;
+							}
+						}
+						break;
+						case EGL_PIXEL_ASPECT_RATIO:
+						{
+							if (value)
+							{
+								*value = walkerSurface->drawToWindow ? EGL_DISPLAY_SCALING : EGL_UNKNOWN;
+							}
+						}
+						break;
+						case EGL_LARGEST_PBUFFER:
+						{
+							// Value is only returned for pbuffers.
+							if (value && walkerSurface->drawToPBuffer)
+							{
+								*value = walkerSurface->largestPBuffer;
+							}
+						}
+						break;
+						case EGL_MIPMAP_TEXTURE:
+						{
+							if (value && walkerSurface->drawToPBuffer)
+							{
+								*value = walkerSurface->mipmapTexture;
+							}
+						}
+						break;
+						case EGL_MIPMAP_LEVEL:
+						{
+							if (value && walkerSurface->drawToPBuffer)
+							{
+								*value = walkerSurface->mipmapLevel;
+							}
+						}
+						break;
+						case EGL_TEXTURE_FORMAT:
+						{
+							if (value && walkerSurface->drawToPBuffer)
+							{
+								*value = walkerSurface->textureFormat;
+							}
+						}
+						break;
+						case EGL_TEXTURE_TARGET:
+						{
+							if (value && walkerSurface->drawToPBuffer)
+							{
+								*value = walkerSurface->textureTarget;
+							}
+						}
+						break;
+						case EGL_MULTISAMPLE_RESOLVE:
+						{
+							if (value)
+							{
+								*value = walkerSurface->multisampleResolve;
+							}
+						}
+						break;
+						case EGL_RENDER_BUFFER:
+						{
+							if (value)
+							{
+								if (walkerSurface->drawToPBuffer)
+								{
+									*value = EGL_BACK_BUFFER;
+								}
+								else
+								{
+									// A requested change is returned, even if not yet applied.
+									*value = walkerSurface->requestedRenderBuffer;
+								}
+							}
+						}
+						break;
+						case EGL_SWAP_BEHAVIOR:
+						{
+							if (value)
+							{
+								*value = walkerSurface->swapBehavior;
+							}
+						}
+						break;
+						case EGL_BITMAP_POINTER_KHR:
+						case EGL_BITMAP_PITCH_KHR:
+						case EGL_BITMAP_ORIGIN_KHR:
+						case EGL_BITMAP_PIXEL_RED_OFFSET_KHR:
+						case EGL_BITMAP_PIXEL_GREEN_OFFSET_KHR:
+						case EGL_BITMAP_PIXEL_BLUE_OFFSET_KHR:
+						case EGL_BITMAP_PIXEL_ALPHA_OFFSET_KHR:
+						case EGL_BITMAP_PIXEL_LUMINANCE_OFFSET_KHR:
+						case EGL_BITMAP_PIXEL_SIZE_KHR:
+						{
+							EGLAttribKHR bitmapValue;
+
+							if (!_eglInternalQueryBitmap(walkerSurface, attribute, &bitmapValue))
+							{
+								return EGL_FALSE;
+							}
+
+							// A pointer, which does not fit, can only be queried by eglQuerySurface64KHR.
+							if ((EGLAttribKHR)(EGLint)bitmapValue != bitmapValue)
+							{
+								g_localStorage.error = EGL_BAD_ACCESS;
+
+								return EGL_FALSE;
+							}
+
+							if (value)
+							{
+								*value = (EGLint)bitmapValue;
+							}
+						}
+						break;
+						case EGL_VG_ALPHA_FORMAT:
+						{
+							// OpenVG is not supported, so the defaults are reported.
+							if (value)
+							{
+								*value = EGL_VG_ALPHA_FORMAT_NONPRE;
+							}
+						}
+						break;
+						case EGL_VG_COLORSPACE:
+						{
+							if (value)
+							{
+								*value = EGL_VG_COLORSPACE_sRGB;
+							}
+						}
+						break;
+						case EGL_PRESENT_QUEUE_DEPTH_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->presentQueueDepth;
+							}
+						}
+						break;
+						case EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->maxFramesInFlight;
+							}
+						}
+						break;
+						case EGL_TIMESTAMPS_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->timestamps;
+							}
+						}
+						break;
+						case EGL_SWAP_GROUP_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->swapGroup;
+							}
+						}
+						break;
+						case EGL_FRAME_EXPORT_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->exportFrames;
+							}
+						}
+						break;
+						case EGL_FRAME_EXPORT_FORMAT_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerSurface->exportFormat;
+							}
+						}
+						break;
+						// Same value as EGL_BUFFER_AGE_KHR.
+						case EGL_BUFFER_AGE_EXT:
+						{
+							// Only the back buffer of the current draw surface has an age.
+							if (walkerDpy->currentCtx != g_localStorage.currentCtx || walkerDpy->currentDraw != walkerSurface)
+							{
+								g_localStorage.error = EGL_BAD_SURFACE;
+
+								return EGL_FALSE;
+							}
+
+							if (value)
+							{
+								*value = walkerSurface->drawToWindow ? __queryBufferAge(walkerDpy, walkerSurface) : 0;
+							}
+
+							walkerSurface->bufferAgeQueried = EGL_TRUE;
+						}
+						break;
+						default:
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+						break;
 					}
+
+					return EGL_TRUE;
 				}
-				break;
-				case EGL_CONFIG_ID:
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return 0;
+			}
+
+			if (_eglInternalIsTrusted(walkerDpy))
+			{
+				return _eglInternalSwapBuffers(walkerDpy, (EGLSurfaceImpl*)surface);
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						*value = walkerConfig->configId;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
+
+					return _eglInternalSwapBuffers(walkerDpy, walkerSurface);
 				}
-				break;
-				case EGL_CONFORMANT:
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglTerminate(EGLDisplay dpy)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_BAD_DISPLAY;
+
+				return EGL_FALSE;
+			}
+
+			walkerDpy->initialized = EGL_FALSE;
+			walkerDpy->destroy = EGL_TRUE;
+
+			// Images are not bound to any thread, so release them together with the display.
+			EGLImageImpl* walkerImage = walkerDpy->rootImage;
+
+			while (walkerImage)
+			{
+				if (!walkerImage->destroy)
 				{
-					if (value)
-					{
-						*value = walkerConfig->conformant;
-					}
+					walkerImage->initialized = EGL_FALSE;
+					walkerImage->destroy = EGL_TRUE;
+
+					__destroyImage(walkerDpy, walkerImage);
 				}
-				break;
-				case EGL_DEPTH_SIZE:
+
+				walkerImage = walkerImage->next;
+			}
+
+			__terminate(walkerDpy);
+
+			_eglInternalCleanup();
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglWaitNative(EGLint engine)
+{
+	if (engine != EGL_CORE_NATIVE_ENGINE)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			break;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	if (g_localStorage.api == EGL_OPENGL_API)
+	{
+		glFinish();
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// EGL_VERSION_1_1
+//
+
+EGLBoolean _eglBindTexImage(EGLDisplay dpy, EGLSurface surface, EGLint buffer)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy || !walkerSurface->drawToPBuffer)
 					{
-						*value = walkerConfig->depthSize;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_GREEN_SIZE:
-				{
-					if (value)
+
+					if (buffer != EGL_BACK_BUFFER)
 					{
-						*value = walkerConfig->greenSize;
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_LEVEL:
-				{
-					if (value)
+
+					if (walkerSurface->textureFormat == EGL_NO_TEXTURE)
 					{
-						*value = walkerConfig->level;
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_LUMINANCE_SIZE:
-				{
-					if (value)
+
+					if (walkerSurface->textureBound)
 					{
-						*value = walkerConfig->luminanceSize;
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_MAX_PBUFFER_WIDTH:
-				{
-					if (value)
+
+					// Without a current context, there is no texture to bind to.
+					if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
 					{
-						*value = walkerConfig->maxPBufferWidth;
+						return EGL_TRUE;
 					}
-				}
-				break;
-				case EGL_MAX_PBUFFER_HEIGHT:
-				{
-					if (value)
+
+					if (!__bindTexImage(walkerDpy, walkerSurface))
 					{
-						*value = walkerConfig->maxPBufferHeight;
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
 					}
+
+					walkerSurface->textureBound = EGL_TRUE;
+
+					return EGL_TRUE;
 				}
-				break;
-				case EGL_MAX_PBUFFER_PIXELS:
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglReleaseTexImage(EGLDisplay dpy, EGLSurface surface, EGLint buffer)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy || !walkerSurface->drawToPBuffer)
 					{
-						*value = walkerConfig->maxPBufferPixels;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_MAX_SWAP_INTERVAL:
-				{
-					if (value)
+
+					if (buffer != EGL_BACK_BUFFER)
 					{
-						*value = walkerConfig->maxSwapInterval;
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_MIN_SWAP_INTERVAL:
-				{
-					if (value)
+
+					if (walkerSurface->textureFormat == EGL_NO_TEXTURE)
 					{
-						*value = walkerConfig->minSwapInterval;
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_NATIVE_RENDERABLE:
-				{
-					if (value)
+
+					// Releasing a not bound surface is ignored.
+					if (!walkerSurface->textureBound)
 					{
-						*value = walkerConfig->nativeRenderable;
+						return EGL_TRUE;
 					}
+
+					__releaseTexImage(walkerDpy, walkerSurface);
+
+					walkerSurface->textureBound = EGL_FALSE;
+
+					return EGL_TRUE;
 				}
-				break;
-				case EGL_NATIVE_VISUAL_ID:
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSurfaceAttrib(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						*value = walkerConfig->nativeVisualId;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_NATIVE_VISUAL_TYPE:
-				{
-					if (value)
+
+					EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+					while (walkerConfig)
 					{
-						*value = walkerConfig->nativeVisualType;
+						if (walkerConfig->configId == walkerSurface->configId)
+						{
+							break;
+						}
+
+						walkerConfig = walkerConfig->next;
 					}
-				}
-				break;
-				case EGL_RED_SIZE:
-				{
-					if (value)
+
+					if (!walkerConfig)
 					{
-						*value = walkerConfig->redSize;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_RENDERABLE_TYPE:
-				{
-					if (value)
+
+					switch (attribute)
 					{
-						*value = walkerConfig->renderableType;
+						case EGL_MIPMAP_LEVEL:
+						{
+							// Only has an effect on pbuffers, which can be bound as a texture.
+							if (value < 0)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->mipmapLevel = value;
+						}
+						break;
+						case EGL_MULTISAMPLE_RESOLVE:
+						{
+							if (value == EGL_MULTISAMPLE_RESOLVE_BOX)
+							{
+								if (!(walkerConfig->surfaceType & EGL_MULTISAMPLE_RESOLVE_BOX_BIT))
+								{
+									g_localStorage.error = EGL_BAD_MATCH;
+
+									return EGL_FALSE;
+								}
+							}
+							else if (value != EGL_MULTISAMPLE_RESOLVE_DEFAULT)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->multisampleResolve = value;
+						}
+						break;
+						case EGL_SWAP_BEHAVIOR:
+						{
+							if (value == EGL_BUFFER_PRESERVED)
+							{
+								if (!(walkerConfig->surfaceType & EGL_SWAP_BEHAVIOR_PRESERVED_BIT))
+								{
+									g_localStorage.error = EGL_BAD_MATCH;
+
+									return EGL_FALSE;
+								}
+							}
+							else if (value != EGL_BUFFER_DESTROYED)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->swapBehavior = value;
+						}
+						break;
+						case EGL_RENDER_BUFFER:
+						{
+							if (value != EGL_SINGLE_BUFFER && value != EGL_BACK_BUFFER)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (!walkerSurface->mutableRenderBuffer || !(walkerConfig->surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value == EGL_SINGLE_BUFFER && walkerSurface->presentQueueDepth > 0)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// Takes effect at the next swap.
+							walkerSurface->requestedRenderBuffer = value;
+						}
+						break;
+						case EGL_PRESENT_QUEUE_DEPTH_DESKTOP:
+						{
+							if (value < 0 || value > MAX_PRESENT_QUEUE_DEPTH)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value > 0 && (!walkerSurface->drawToWindow || !__hasPresentQueue(walkerDpy, walkerSurface)))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// Frames of the present thread can not be held by a swap group or be read back.
+							if (value > 0 && (walkerSurface->swapGroup > 0 || walkerSurface->exportFrames))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// The present thread can not present a front buffer.
+							if (value > 0 && (walkerSurface->renderBuffer == EGL_SINGLE_BUFFER || walkerSurface->requestedRenderBuffer == EGL_SINGLE_BUFFER))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// Takes effect at the next swap.
+							walkerSurface->presentQueueDepth = value;
+						}
+						break;
+						case EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP:
+						{
+							if (value < 0 || value > MAX_FRAMES_IN_FLIGHT)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value > 0 && !_eglInternalHasFences())
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->maxFramesInFlight = value;
+						}
+						break;
+						case EGL_TIMESTAMPS_DESKTOP:
+						{
+							if (value != EGL_TRUE && value != EGL_FALSE)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (!walkerSurface->drawToWindow)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value && !walkerSurface->timestamps)
+							{
+								EGLnsecsANDROID presentTime;
+
+								// Following swaps are counted from the current one.
+								walkerSurface->presentCounterKnown = __getPresentCounter(walkerDpy, walkerSurface, &walkerSurface->nextPresentCounter, &presentTime);
+							}
+							else if (!value && walkerSurface->timestamps)
+							{
+								_eglInternalReleaseFrameTimestamps(walkerDpy, walkerSurface);
+							}
+
+							walkerSurface->timestamps = (EGLBoolean)value;
+						}
+						break;
+						case EGL_SWAP_GROUP_DESKTOP:
+						{
+							if (value < 0)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (!walkerSurface->drawToWindow || (value > 0 && walkerSurface->presentQueueDepth > 0))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value != walkerSurface->swapGroup)
+							{
+								_eglInternalLeaveSwapGroup(walkerDpy, walkerSurface);
+
+								walkerSurface->swapGroup = value;
+							}
+						}
+						break;
+						case EGL_FRAME_EXPORT_DESKTOP:
+						{
+							if (value != EGL_TRUE && value != EGL_FALSE)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value && (walkerSurface->drawToPixmap || walkerSurface->presentQueueDepth > 0 || !_eglInternalHasPixelBuffers()))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (!value && walkerSurface->exportFrames)
+							{
+								_eglInternalReleaseFrameExport(walkerDpy, walkerSurface);
+							}
+
+							walkerSurface->exportFrames = (EGLBoolean)value;
+						}
+						break;
+						case EGL_FRAME_EXPORT_FORMAT_DESKTOP:
+						{
+							if (value != EGL_FRAME_EXPORT_RGBA_DESKTOP && value != EGL_FRAME_EXPORT_NV12_DESKTOP && value != EGL_FRAME_EXPORT_I420_DESKTOP)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value != EGL_FRAME_EXPORT_RGBA_DESKTOP && !_eglInternalHasColorConversion())
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// The shaders can only be compiled by the context, which renders to the surface. Otherwise, this is done at the next swap.
+							if (value != EGL_FRAME_EXPORT_RGBA_DESKTOP && _eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+							{
+								_eglInternalBindFrameExport(walkerDpy, walkerSurface);
+
+								if (!_eglInternalCreateColorConversion(&walkerSurface->frameExport))
+								{
+									g_localStorage.error = EGL_BAD_MATCH;
+
+									return EGL_FALSE;
+								}
+							}
+
+							// Takes effect at the next swap.
+							walkerSurface->exportFormat = value;
+						}
+						break;
+						default:
+						{
+							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+							return EGL_FALSE;
+						}
+						break;
 					}
+
+					return EGL_TRUE;
 				}
-				break;
-				case EGL_SAMPLE_BUFFERS:
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_BAD_DISPLAY;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentDraw == EGL_NO_SURFACE || walkerDpy->currentRead == EGL_NO_SURFACE)
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentCtx == EGL_NO_CONTEXT)
+			{
+				g_localStorage.error = EGL_BAD_CONTEXT;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->currentDraw;
+
+			// Negative intervals allow late swaps to tear, so only the magnitude is clamped.
+			EGLint magnitude = interval < 0 ? -interval : interval;
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if (walkerConfig->configId == walkerSurface->configId)
 				{
-					if (value)
+					if (walkerConfig->minSwapInterval != EGL_DONT_CARE && magnitude < walkerConfig->minSwapInterval)
 					{
-						*value = walkerConfig->sampleBuffers;
+						magnitude = walkerConfig->minSwapInterval;
 					}
-				}
-				break;
-				case EGL_SAMPLES:
-				{
-					if (value)
+					if (walkerConfig->maxSwapInterval != EGL_DONT_CARE && magnitude > walkerConfig->maxSwapInterval)
 					{
-						*value = walkerConfig->samples;
+						magnitude = walkerConfig->maxSwapInterval;
 					}
+
+					break;
 				}
-				break;
-				case EGL_STENCIL_SIZE:
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			interval = interval < 0 ? -magnitude : magnitude;
+
+			walkerSurface->swapInterval = interval;
+
+			// Other surfaces keep the interval, until it is applied to the window.
+			if (!walkerSurface->drawToWindow)
+			{
+				return EGL_TRUE;
+			}
+
+			return _eglInternalApplySwapInterval(walkerDpy, walkerSurface);
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_VERSION_1_2
+//
+
+EGLBoolean _eglBindAPI(EGLenum api)
+{
+	if (api == EGL_OPENGL_API)
+	{
+		g_localStorage.api = api;
+
+		return EGL_TRUE;
+	}
+
+	g_localStorage.error = EGL_BAD_PARAMETER;
+
+	return EGL_FALSE;
+}
+
+EGLenum _eglQueryAPI(void)
+{
+	return g_localStorage.api;
+}
+
+EGLBoolean _eglWaitClient(void)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_TRUE;
+	}
+
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			break;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	if (g_localStorage.api == EGL_OPENGL_API)
+	{
+		glFinish();
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// EGL_VERSION_1_3
+//
+
+//
+// EGL_VERSION_1_4
+//
+
+EGLContext _eglGetCurrentContext(void)
+{
+	return g_localStorage.currentCtx;
+}
+
+//
+// EGL_VERSION_1_5
+//
+
+EGLDisplay _eglGetPlatformDisplay(EGLenum platform, void *native_display, const EGLAttrib *attrib_list)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	// No EGL platform is registered for native Windows displays, so these are only created by eglGetDisplay.
+	(void)platform;
+	(void)native_display;
+	(void)attrib_list;
+
+	g_localStorage.error = EGL_BAD_PARAMETER;
+
+	return EGL_NO_DISPLAY;
+#else
+	if (platform != EGL_PLATFORM_X11_KHR)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_NO_DISPLAY;
+	}
+
+	EGLBoolean noValidation = EGL_FALSE;
+
+	if (attrib_list)
+	{
+		EGLint attribListIndex = 0;
+
+		while (attrib_list[attribListIndex] != EGL_NONE)
+		{
+			// More than 2 entries can not exist.
+			if (attribListIndex >= 2 * 2)
+			{
+				g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_NO_DISPLAY;
+			}
+
+			EGLAttrib value = attrib_list[attribListIndex + 1];
+
+			switch (attrib_list[attribListIndex])
+			{
+				case EGL_PLATFORM_X11_SCREEN_KHR:
 				{
-					if (value)
+					// The default screen of the display is used.
+					if (value < 0)
 					{
-						*value = walkerConfig->stencilSize;
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_NO_DISPLAY;
 					}
 				}
 				break;
-				case EGL_SURFACE_TYPE:
+				case EGL_NO_VALIDATION_DESKTOP:
 				{
-					if (value)
+					if (value != EGL_TRUE && value != EGL_FALSE)
 					{
-						*value = walkerConfig->surfaceType;
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_NO_DISPLAY;
 					}
+
+					noValidation = (EGLBoolean)value;
 				}
 				break;
-				case EGL_TRANSPARENT_TYPE:
+				default:
 				{
-					if (value)
-					{
-						*value = walkerConfig->transparentType;
-					}
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_NO_DISPLAY;
 				}
 				break;
-				case EGL_TRANSPARENT_RED_VALUE:
+			}
+
+			attribListIndex += 2;
+		}
+	}
+
+	EGLDisplay dpy = _eglGetDisplay((EGLNativeDisplayType)native_display);
+
+	if (dpy != EGL_NO_DISPLAY)
+	{
+		((EGLDisplayImpl*)dpy)->noValidation = noValidation;
+	}
+
+	return dpy;
+#endif
+}
+
+EGLSurface _eglCreatePlatformPixmapSurface(EGLDisplay dpy, EGLConfig config, void *native_pixmap, const EGLAttrib *attrib_list)
+{
+	if (!native_pixmap)
+	{
+		g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_NO_SURFACE;
+	}
+
+	// Same amount of entries as for the non platform function.
+	EGLint target_attrib_list[4 * 2 + 1];
+
+	if (attrib_list)
+	{
+		EGLint attribListIndex = 0;
+
+		while (attrib_list[attribListIndex] != EGL_NONE)
+		{
+			if (attribListIndex >= 4 * 2)
+			{
+				g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_NO_SURFACE;
+			}
+
+			target_attrib_list[attribListIndex] = (EGLint)attrib_list[attribListIndex];
+			target_attrib_list[attribListIndex + 1] = (EGLint)attrib_list[attribListIndex + 1];
+
+			attribListIndex += 2;
+		}
+
+		target_attrib_list[attribListIndex] = EGL_NONE;
+	}
+
+	// The native pixmap is passed as a pointer to the native handle.
+	return _eglCreatePixmapSurface(dpy, config, *(EGLNativePixmapType*)native_pixmap, attrib_list ? target_attrib_list : 0);
+}
+
+EGLImage _eglCreateImage(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_IMAGE;
+			}
+
+			if (target != EGL_NATIVE_PIXMAP_KHR)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_NO_IMAGE;
+			}
+
+			// A native pixmap is not owned by any client API context.
+			if (ctx != EGL_NO_CONTEXT)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_NO_IMAGE;
+			}
+
+			if (attrib_list)
+			{
+				EGLint attribListIndex = 0;
+
+				while (attrib_list[attribListIndex] != EGL_NONE)
 				{
-					if (value)
+					EGLint value = attrib_list[attribListIndex + 1];
+
+					switch (attrib_list[attribListIndex])
 					{
-						*value = walkerConfig->transparentRedValue;
+						case EGL_IMAGE_PRESERVED_KHR:
+						{
+							// The pixmap is the storage of the image, so the content is always preserved.
+							if (value != EGL_TRUE && value != EGL_FALSE)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_NO_IMAGE;
+							}
+						}
+						break;
+						default:
+						{
+							g_localStorage.error = EGL_BAD_PARAMETER;
+
+							return EGL_NO_IMAGE;
+						}
+						break;
 					}
+
+					attribListIndex += 2;
 				}
-				break;
-				case EGL_TRANSPARENT_GREEN_VALUE:
+			}
+
+			EGLImageImpl* newImage = (EGLImageImpl*)malloc(sizeof(EGLImageImpl));
+
+			if (!newImage)
+			{
+				g_localStorage.error = EGL_BAD_ALLOC;
+
+				return EGL_NO_IMAGE;
+			}
+
+			if (!__createImage(newImage, target, buffer, walkerDpy, &g_localStorage.error))
+			{
+				free(newImage);
+
+				return EGL_NO_IMAGE;
+			}
+
+			newImage->initialized = EGL_TRUE;
+			newImage->destroy = EGL_FALSE;
+			newImage->target = target;
+
+			newImage->next = walkerDpy->rootImage;
+			walkerDpy->rootImage = newImage;
+
+			return (EGLImage)newImage;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_IMAGE;
+}
+
+EGLBoolean _eglDestroyImage(EGLDisplay dpy, EGLImage image)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLImageImpl* walkerImage = walkerDpy->rootImage;
+
+			while (walkerImage)
+			{
+				if ((EGLImage)walkerImage == image)
 				{
-					if (value)
+					if (!walkerImage->initialized || walkerImage->destroy)
 					{
-						*value = walkerConfig->transparentGreenValue;
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
 					}
+
+					walkerImage->initialized = EGL_FALSE;
+					walkerImage->destroy = EGL_TRUE;
+
+					__destroyImage(walkerDpy, walkerImage);
+
+					_eglInternalCleanup();
+
+					return EGL_TRUE;
 				}
-				break;
-				case EGL_TRANSPARENT_BLUE_VALUE:
+
+				walkerImage = walkerImage->next;
+			}
+
+			g_localStorage.error = EGL_BAD_PARAMETER;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_KHR_swap_buffers_with_damage
+//
+
+EGLBoolean _eglSwapBuffersWithDamage(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			if (_eglInternalIsTrusted(walkerDpy))
+			{
+				return _eglInternalSwapBuffersWithDamage(walkerDpy, (EGLSurfaceImpl*)surface, rects, n_rects);
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						*value = walkerConfig->transparentBlueValue;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				default:
-				{
-					g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					return EGL_FALSE;
+					return _eglInternalSwapBuffersWithDamage(walkerDpy, walkerSurface, rects, n_rects);
 				}
-				break;
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			return EGL_TRUE;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -1552,29 +6237,12 @@ EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribut
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size, EGLint *num_config)
-{
-	if (!configs)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
-
-	if (config_size == 0)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
-
-	if (!num_config)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
+//
+// EGL_KHR_partial_update
+//
 
+EGLBoolean _eglSetDamageRegion(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects)
+{
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
 	while (walkerDpy)
@@ -1588,22 +6256,62 @@ EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size
 				return EGL_FALSE;
 			}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
-
-			EGLint configIndex = 0;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			while (walkerConfig && configIndex < config_size)
+			while (walkerSurface)
 			{
-				configs[configIndex] = walkerConfig;
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-				walkerConfig = walkerConfig->next;
+						return EGL_FALSE;
+					}
 
-				configIndex++;
+					if (n_rects < 0 || (n_rects > 0 && !rects))
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
+					}
+
+					// Only the posted draw surface of this thread, which does not preserve its content.
+					if (!walkerSurface->drawToWindow || walkerDpy->currentCtx != g_localStorage.currentCtx || walkerDpy->currentDraw != walkerSurface || walkerSurface->swapBehavior == EGL_BUFFER_PRESERVED)
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+
+					// Once per frame and only after the buffer age is known.
+					if (walkerSurface->damageRegionSet || !walkerSurface->bufferAgeQueried)
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					walkerSurface->damageRegionSet = EGL_TRUE;
+					walkerSurface->damageRectsCount = 0;
+
+					// No rectangles means, that the whole surface is damaged.
+					if (n_rects > 0)
+					{
+						__updateSurfaceSize(walkerDpy, walkerSurface);
+
+						walkerSurface->damageRectsCount = _eglInternalMergeDamage(walkerSurface->damageRects, rects, n_rects, walkerSurface->width, walkerSurface->height);
+					}
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			*num_config = configIndex;
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			return EGL_TRUE;
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -1614,122 +6322,179 @@ EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size
 	return EGL_FALSE;
 }
 
-EGLDisplay _eglGetCurrentDisplay(void)
-{
-	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
-	{
-		return EGL_NO_DISPLAY;
-	}
+//
+// EGL_DESKTOP_display_statistics
+//
 
+EGLBoolean _eglQueryDisplayStatistics(EGLDisplay dpy, EGLint attribute, EGLAttrib* value)
+{
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			return (EGLDisplay)walkerDpy;
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			if (!value)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_MAKE_CURRENT_CALLS_DESKTOP:
+				{
+					*value = walkerDpy->makeCurrentCalls;
+				}
+				break;
+				case EGL_MAKE_CURRENT_SKIPPED_DESKTOP:
+				{
+					*value = walkerDpy->makeCurrentSkipped;
+				}
+				break;
+				default:
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
 
-	return EGL_NO_DISPLAY;
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
 }
 
-EGLSurface _eglGetCurrentSurface(EGLint readdraw)
-{
-	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
-	{
-		return EGL_NO_SURFACE;
-	}
+//
+// EGL_ANDROID_presentation_time
+//
 
+EGLBoolean _eglPresentationTime(EGLDisplay dpy, EGLSurface surface, EGLnsecsANDROID time)
+{
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if (readdraw == EGL_DRAW)
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				return (EGLSurface)walkerDpy->currentDraw;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
 			}
-			else if (readdraw == EGL_READ)
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
 			{
-				return (EGLSurface)walkerDpy->currentRead;
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					// Only used by the next swap of a window.
+					walkerSurface->presentationTime = time;
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			return EGL_NO_SURFACE;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
 
-	return EGL_NO_SURFACE;
-}
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-EGLDisplay _eglGetDisplay(EGLNativeDisplayType display_id)
-{
-	if (!_eglInternalInit())
-	{
-		return EGL_NO_DISPLAY;
-	}
+	return EGL_FALSE;
+}
 
-	//
+//
+// EGL_DESKTOP_frame_timestamps
+//
 
+EGLBoolean _eglGetNextFrameId(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR* frameId)
+{
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->display_id == display_id)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			return (EGLDisplay)walkerDpy;
-		}
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-		walkerDpy = walkerDpy->next;
-	}
+				return EGL_FALSE;
+			}
 
-	EGLDisplayImpl* newDpy = (EGLDisplayImpl*)malloc(sizeof(EGLDisplayImpl));
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-	if (!newDpy)
-	{
-		return EGL_NO_DISPLAY;
-	}
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy || !walkerSurface->timestamps)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-	newDpy->initialized = EGL_FALSE;
-	newDpy->destroy = EGL_FALSE;
-#if defined(_WIN32) || defined(_WIN64)
-	newDpy->display_id = display_id ? display_id : g_localStorage.dummy.hdc;
-#else
-	newDpy->display_id = display_id ? display_id : g_localStorage.dummy.display;
-#endif
-	newDpy->rootSurface = 0;
-	newDpy->rootCtx = 0;
-	newDpy->rootConfig = 0;
-	newDpy->currentDraw = EGL_NO_SURFACE;
-	newDpy->currentRead = EGL_NO_SURFACE;
-	newDpy->currentCtx = EGL_NO_CONTEXT;
-	newDpy->next = g_localStorage.rootDpy;
+						return EGL_FALSE;
+					}
 
-	g_localStorage.rootDpy = newDpy;
+					if (!frameId)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-	return newDpy;
-}
+						return EGL_FALSE;
+					}
 
-EGLint _eglGetError(void)
-{
-	EGLint currentError = g_localStorage.error;
+					*frameId = walkerSurface->nextFrameId;
 
-	g_localStorage.error = EGL_SUCCESS;
+					return EGL_TRUE;
+				}
 
-	return currentError;
-}
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-__eglMustCastToProperFunctionPointerType _eglGetProcAddress(const char *procname)
-{
-	return __getProcAddress(procname);
+	return EGL_FALSE;
 }
 
-EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
+EGLBoolean _eglGetFrameTimestamps(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint* timestamps, EGLnsecsANDROID* values)
 {
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
@@ -1737,34 +6502,85 @@ EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
 	{
 		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if (walkerDpy->initialized || walkerDpy->destroy)
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
-			if (!__initialize(walkerDpy, &g_localStorage.dummy, &g_localStorage.error))
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
 			{
-				return EGL_FALSE;
-			}
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy || !walkerSurface->timestamps)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-			walkerDpy->initialized = EGL_TRUE;
+						return EGL_FALSE;
+					}
 
+					if (numTimestamps < 0 || (numTimestamps > 0 && (!timestamps || !values)))
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-			//
+						return EGL_FALSE;
+					}
 
-			if (major)
-			{
-				*major = 1;
-			}
+					// Only the latest frames are kept.
+					if (frameId >= walkerSurface->nextFrameId || walkerSurface->nextFrameId - frameId > FRAME_TIMESTAMPS_SIZE)
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
 
-			if (minor)
-			{
-				*minor = 5;
+						return EGL_FALSE;
+					}
+
+					_eglInternalUpdateFrameTimestamps(walkerDpy, walkerSurface);
+
+					const EGLFrameTimestampsImpl* frameTimestamps = &walkerSurface->frameTimestamps[frameId % FRAME_TIMESTAMPS_SIZE];
+
+					EGLint i;
+
+					for (i = 0; i < numTimestamps; i++)
+					{
+						switch (timestamps[i])
+						{
+							case EGL_SWAP_REQUESTED_TIME_DESKTOP:
+							{
+								values[i] = frameTimestamps->swapRequestedTime;
+							}
+							break;
+							case EGL_RENDERING_COMPLETE_TIME_DESKTOP:
+							{
+								values[i] = frameTimestamps->renderingCompleteTime;
+							}
+							break;
+							case EGL_DISPLAY_PRESENT_TIME_DESKTOP:
+							{
+								values[i] = frameTimestamps->displayPresentTime;
+							}
+							break;
+							default:
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+							break;
+						}
+					}
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			return EGL_TRUE;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -1775,17 +6591,14 @@ EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx)
+//
+// EGL_DESKTOP_swap_buffers_batch
+//
+
+EGLBoolean _eglSwapBuffersBatch(EGLDisplay dpy, EGLint count, const EGLSurface* surfaces, const EGLint* const* rects, const EGLint* n_rects)
 {
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
-	if ((ctx == EGL_NO_CONTEXT && (draw != EGL_NO_SURFACE || read != EGL_NO_SURFACE)) || (ctx != EGL_NO_CONTEXT && (draw == EGL_NO_SURFACE || read == EGL_NO_SURFACE)))
-	{
-		g_localStorage.error = EGL_BAD_MATCH;
-
-		return EGL_FALSE;
-	}
-
 	while (walkerDpy)
 	{
 		if ((EGLDisplay)walkerDpy == dpy)
@@ -1797,39 +6610,43 @@ EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGL
 				return EGL_FALSE;
 			}
 
-			EGLSurfaceImpl* currentDraw = EGL_NO_SURFACE;
-			EGLSurfaceImpl* currentRead = EGL_NO_SURFACE;
-			EGLContextImpl* currentCtx = EGL_NO_CONTEXT;
+			if (count < 0 || (count > 0 && !surfaces))
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-			NativeSurfaceContainer* nativeSurfaceContainer = 0;
-			NativeContextContainer* nativeContextContainer = 0;
+				return EGL_FALSE;
+			}
 
-			EGLBoolean result;
+			EGLint indexSurface;
 
-			if (draw != EGL_NO_SURFACE)
+			// All surfaces and rectangles are validated, before any of them is swapped.
+			for (indexSurface = 0; indexSurface < count; indexSurface++)
 			{
+				if (n_rects && (n_rects[indexSurface] < 0 || (n_rects[indexSurface] > 0 && (!rects || !rects[indexSurface]))))
+				{
+					g_localStorage.error = EGL_BAD_PARAMETER;
+
+					return EGL_FALSE;
+				}
+
+				if (_eglInternalIsTrusted(walkerDpy))
+				{
+					continue;
+				}
+
 				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
 				while (walkerSurface)
 				{
-					if ((EGLSurface)walkerSurface == draw)
+					if ((EGLSurface)walkerSurface == surfaces[indexSurface])
 					{
-						if (!walkerSurface->initialized || walkerSurface->destroy)
-						{
-							g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
-
-							return EGL_FALSE;
-						}
-
-						currentDraw = walkerSurface;
-
 						break;
 					}
 
 					walkerSurface = walkerSurface->next;
 				}
 
-				if (!currentDraw)
+				if (!walkerSurface || !walkerSurface->initialized || walkerSurface->destroy)
 				{
 					g_localStorage.error = EGL_BAD_SURFACE;
 
@@ -1837,190 +6654,363 @@ EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGL
 				}
 			}
 
-			if (read != EGL_NO_SURFACE)
+			EGLBoolean result = EGL_TRUE;
+
+			for (indexSurface = 0; indexSurface < count; indexSurface++)
 			{
-				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+				EGLSurfaceImpl* walkerSurface = (EGLSurfaceImpl*)surfaces[indexSurface];
 
-				while (walkerSurface)
+				// Given damage replaces the damage region of the frame.
+				if (walkerSurface->drawToWindow && n_rects && n_rects[indexSurface] > 0)
 				{
-					if ((EGLSurface)walkerSurface == read)
-					{
-						if (!walkerSurface->initialized || walkerSurface->destroy)
-						{
-							g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
-
-							return EGL_FALSE;
-						}
-
-						currentRead = walkerSurface;
-
-						break;
-					}
+					__updateSurfaceSize(walkerDpy, walkerSurface);
 
-					walkerSurface = walkerSurface->next;
+					walkerSurface->damageRectsCount = _eglInternalMergeDamage(walkerSurface->damageRects, rects[indexSurface], n_rects[indexSurface], walkerSurface->width, walkerSurface->height);
+					walkerSurface->damageRegionSet = EGL_TRUE;
 				}
 
-				if (!currentRead)
+				if (!_eglInternalSwapBuffers(walkerDpy, walkerSurface))
 				{
-					g_localStorage.error = EGL_BAD_SURFACE;
-
-					return EGL_FALSE;
+					result = EGL_FALSE;
 				}
 			}
 
-			if (ctx != EGL_NO_CONTEXT)
+			// The swaps are only sent once to the window system.
+			if (count > 0)
 			{
-				EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+				__flushSwaps(walkerDpy);
+			}
 
-				while (walkerCtx)
+			return result;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_DESKTOP_frame_export
+//
+
+EGLBoolean _eglGetExportedFrame(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR* frameId, void** pixels, EGLint* width, EGLint* height, EGLint* pitch)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if ((EGLContext)walkerCtx == ctx)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						if (!walkerCtx->initialized || walkerCtx->destroy)
-						{
-							g_localStorage.error = EGL_BAD_CONTEXT;
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-							return EGL_FALSE;
-						}
+						return EGL_FALSE;
+					}
 
-						currentCtx = walkerCtx;
+					if (!walkerSurface->exportFrames)
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
 
-						break;
+						return EGL_FALSE;
 					}
 
-					walkerCtx = walkerCtx->next;
-				}
+					// Only the context, which did read back the frames, can map them.
+					if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-				if (!currentCtx)
-				{
-					g_localStorage.error = EGL_BAD_CONTEXT;
+						return EGL_FALSE;
+					}
 
-					return EGL_FALSE;
+					EGLFrameExportImpl* frameExport = &walkerSurface->frameExport;
+
+					if (frameExport->ctx == walkerDpy->currentCtx)
+					{
+						_eglInternalMapExportedFrame(frameExport);
+					}
+
+					// No frame is complete yet, which is not an error.
+					if (frameExport->mapped < 0)
+					{
+						if (pixels)
+						{
+							*pixels = 0;
+						}
+
+						return EGL_TRUE;
+					}
+
+					if (frameId)
+					{
+						*frameId = frameExport->frameIds[frameExport->mapped];
+					}
+					if (pixels)
+					{
+						*pixels = frameExport->pixels;
+					}
+					if (width)
+					{
+						*width = frameExport->width;
+					}
+					if (height)
+					{
+						*height = frameExport->height;
+					}
+					if (pitch)
+					{
+						*pitch = frameExport->pitch;
+					}
+
+					return EGL_TRUE;
 				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			if (currentDraw != EGL_NO_SURFACE)
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_DESKTOP_frame_ring
+//
+
+EGLBoolean _eglCreateFrameRing(EGLDisplay dpy, EGLSurface surface, const EGLint* attrib_list, EGLint* fd)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				nativeSurfaceContainer = &currentDraw->nativeSurfaceContainer;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
 			}
 
-			if (currentCtx != EGL_NO_CONTEXT)
-			{
-				EGLContextListImpl* ctxList = currentCtx->rootCtxList;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-				while (ctxList)
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (ctxList->surface == currentDraw)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						break;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
 
-					ctxList = ctxList->next;
-				}
+					if (!fd)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-				if (!ctxList)
-				{
-					ctxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+						return EGL_FALSE;
+					}
 
-					if (!ctxList)
+					if (walkerSurface->frameRing.header)
 					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
 						return EGL_FALSE;
 					}
 
-					// Gather shared context, if one exists.
-					EGLContextListImpl* sharedCtxList = 0;
-					if (currentCtx->sharedCtx)
+					if (!_eglInternalHasPixelBuffers())
 					{
-						EGLContextImpl* sharedWalkerCtx = currentCtx->sharedCtx;
+						g_localStorage.error = EGL_BAD_MATCH;
 
-						EGLContextImpl* beforeSharedWalkerCtx = 0;
+						return EGL_FALSE;
+					}
 
-						while (sharedWalkerCtx)
-						{
-							// Check, if already created.
-							if (sharedWalkerCtx->rootCtxList)
-							{
-								sharedCtxList = sharedWalkerCtx->rootCtxList;
+					__updateSurfaceSize(walkerDpy, walkerSurface);
 
-								break;
-							}
+					// Slots have the current size of the surface by default.
+					EGLint maxWidth = walkerSurface->width > 0 ? walkerSurface->width : 1;
+					EGLint maxHeight = walkerSurface->height > 0 ? walkerSurface->height : 1;
+					EGLint slotCount = FRAME_RING_DEFAULT_SLOTS;
+					EGLint timeout = FRAME_RING_DEFAULT_TIMEOUT;
 
-							beforeSharedWalkerCtx = sharedWalkerCtx;
-							sharedWalkerCtx = sharedWalkerCtx->sharedCtx;
+					if (attrib_list)
+					{
+						EGLint indexAttribList = 0;
 
-							// No created shared context found.
-							if (!sharedWalkerCtx)
-							{
-								sharedCtxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+						while (attrib_list[indexAttribList] != EGL_NONE)
+						{
+							EGLint value = attrib_list[indexAttribList + 1];
 
-								if (!sharedCtxList)
+							switch (attrib_list[indexAttribList])
+							{
+								case EGL_WIDTH:
 								{
-									free(ctxList);
+									if (value <= 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
 
-									return EGL_FALSE;
+										return EGL_FALSE;
+									}
+
+									maxWidth = value;
 								}
+								break;
+								case EGL_HEIGHT:
+								{
+									if (value <= 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
 
-								result = __createContext(&sharedCtxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, 0, beforeSharedWalkerCtx->attribList);
+										return EGL_FALSE;
+									}
 
-								if (!result)
+									maxHeight = value;
+								}
+								break;
+								case EGL_FRAME_RING_SLOTS_DESKTOP:
 								{
-									free(sharedCtxList);
+									// Counters wrap around at 2^32, which only a power of two divides.
+									if (value < 1 || value > EGL_FRAME_RING_MAX_SLOTS_DESKTOP || (value & (value - 1)) != 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
 
-									free(ctxList);
+										return EGL_FALSE;
+									}
 
-									return EGL_FALSE;
+									slotCount = value;
 								}
+								break;
+								case EGL_FRAME_RING_TIMEOUT_DESKTOP:
+								{
+									if (value < 0)
+									{
+										g_localStorage.error = EGL_BAD_PARAMETER;
 
-								sharedCtxList->surface = currentDraw;
+										return EGL_FALSE;
+									}
 
-								sharedCtxList->next = beforeSharedWalkerCtx->rootCtxList;
-								beforeSharedWalkerCtx->rootCtxList = sharedCtxList;
+									timeout = value;
+								}
+								break;
+								default:
+								{
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_FALSE;
+								}
+								break;
 							}
-						}
-					}
-					else
-					{
-						// Use own context as shared context, if one exits.
 
-						sharedCtxList = currentCtx->rootCtxList;
+							indexAttribList += 2;
+						}
 					}
 
-					result = __createContext(&ctxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, sharedCtxList ? &sharedCtxList->nativeContextContainer : 0, currentCtx->attribList);
+					EGLFrameRingImpl* frameRing = &walkerSurface->frameRing;
 
-					if (!result)
+					if (!__createFrameRing(walkerDpy, frameRing, slotCount, (size_t)maxWidth * (size_t)maxHeight * 4, &g_localStorage.error))
 					{
-						free(ctxList);
-
 						return EGL_FALSE;
 					}
 
-					ctxList->surface = currentDraw;
+					frameRing->maxWidth = maxWidth;
+					frameRing->maxHeight = maxHeight;
+					frameRing->timeout = timeout;
 
-					ctxList->next = currentCtx->rootCtxList;
-					currentCtx->rootCtxList = ctxList;
+					// Buffers are created by the context, which renders the first frame.
+					frameRing->ctx = 0;
+
+					*fd = frameRing->fd;
+
+					return EGL_TRUE;
 				}
 
-				nativeContextContainer = &ctxList->nativeContextContainer;
+				walkerSurface = walkerSurface->next;
 			}
 
-			result = __makeCurrent(walkerDpy, nativeSurfaceContainer, nativeContextContainer);
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			if (!result)
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglDestroyFrameRing(EGLDisplay dpy, EGLSurface surface)
+{
+	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				g_localStorage.error = EGL_BAD_MATCH;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
-			walkerDpy->currentDraw = currentDraw;
-			walkerDpy->currentRead = currentRead;
-			walkerDpy->currentCtx = currentCtx;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			g_localStorage.currentCtx = currentCtx;
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-			_eglInternalCleanup();
+						return EGL_FALSE;
+					}
 
-			return EGL_TRUE;
+					if (!walkerSurface->frameRing.header)
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+
+					_eglInternalReleaseFrameRing(walkerDpy, walkerSurface);
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2031,7 +7021,11 @@ EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGL
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint *value)
+//
+// EGL_KHR_lock_surface
+//
+
+EGLBoolean _eglLockSurface(EGLDisplay dpy, EGLSurface surface, const EGLint* attrib_list)
 {
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
@@ -2046,166 +7040,164 @@ EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, E
 				return EGL_FALSE;
 			}
 
-			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			while (walkerCtx)
+			while (walkerSurface)
 			{
-				if ((EGLContext)walkerCtx == ctx)
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (!walkerCtx->initialized || walkerCtx->destroy)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
 						return EGL_FALSE;
 					}
 
-					switch (attribute)
-					{
-						case EGL_CONFIG_ID:
-						{
-							if (value)
-							{
-								*value = walkerCtx->configId;
-							}
+					EGLBoolean preservePixels = EGL_FALSE;
+					EGLint usage = EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR;
 
-							return EGL_TRUE;
-						}
-						break;
-						case EGL_CONTEXT_CLIENT_TYPE:
-						{
-							if (value)
-							{
-								*value = EGL_OPENGL_API;
-							}
+					if (attrib_list)
+					{
+						EGLint indexAttribList = 0;
 
-							return EGL_TRUE;
-						}
-						break;
-						case EGL_CONTEXT_CLIENT_VERSION:
+						while (attrib_list[indexAttribList] != EGL_NONE)
 						{
-							// Regarding the specification, it only makes sense for OpenGL ES.
+							EGLint value = attrib_list[indexAttribList + 1];
 
-							return EGL_FALSE;
-						}
-						break;
-						case EGL_RENDER_BUFFER:
-						{
-							if (walkerDpy->currentCtx == walkerCtx)
+							switch (attrib_list[indexAttribList])
 							{
-								EGLSurfaceImpl* currentSurface = walkerDpy->currentDraw ? walkerDpy->currentDraw : walkerDpy->currentRead;
-
-								if (currentSurface)
+								case EGL_MAP_PRESERVE_PIXELS_KHR:
 								{
-									if (currentSurface->drawToWindow)
+									if (value != EGL_TRUE && value != EGL_FALSE)
 									{
-										if (value)
-										{
-											*value = currentSurface->doubleBuffer ? EGL_BACK_BUFFER : EGL_SINGLE_BUFFER;
-										}
+										g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-										return EGL_TRUE;
+										return EGL_FALSE;
 									}
-									else if (currentSurface->drawToPixmap)
-									{
-										if (value)
-										{
-											*value = EGL_SINGLE_BUFFER;
-										}
 
-										return EGL_TRUE;
-									}
-									else if (currentSurface->drawToPBuffer)
+									preservePixels = value;
+								}
+								break;
+								case EGL_LOCK_USAGE_HINT_KHR:
+								{
+									if (value & ~(EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR))
 									{
-										if (value)
-										{
-											*value = EGL_BACK_BUFFER;
-										}
+										g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-										return EGL_TRUE;
+										return EGL_FALSE;
 									}
-								}
 
-								if (value)
-								{
-									*value = EGL_NONE;
+									usage = value;
 								}
-
-								return EGL_FALSE;
-							}
-							else
-							{
-								if (value)
+								break;
+								default:
 								{
-									*value = EGL_NONE;
-								}
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-								return EGL_FALSE;
+									return EGL_FALSE;
+								}
+								break;
 							}
+
+							indexAttribList += 2;
 						}
-						break;
 					}
 
-					g_localStorage.error = EGL_BAD_PARAMETER;
+					EGLSurfaceLockImpl* surfaceLock = &walkerSurface->surfaceLock;
 
-					return EGL_FALSE;
-				}
+					// Surfaces, which are locked or current, can not be locked.
+					if (surfaceLock->locked || (walkerDpy->currentCtx && (walkerDpy->currentDraw == walkerSurface || walkerDpy->currentRead == walkerSurface)))
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+					while (walkerConfig)
+					{
+						if (walkerConfig->configId == walkerSurface->configId)
+						{
+							break;
+						}
+
+						walkerConfig = walkerConfig->next;
+					}
+
+					if (!walkerConfig || !(walkerConfig->surfaceType & EGL_LOCK_SURFACE_BIT_KHR) || !_eglInternalHasSurfaceLock())
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					// Only windows can change their size.
+					if (walkerSurface->drawToWindow)
+					{
+						__updateSurfaceSize(walkerDpy, walkerSurface);
+					}
+
+					EGLint width = walkerSurface->width > 0 ? walkerSurface->width : 1;
+					EGLint height = walkerSurface->height > 0 ? walkerSurface->height : 1;
+
+					// The buffer is reused, until the size of the surface changes. Pixels are only read back, if they have to be preserved and did change since the last transfer.
+					EGLBoolean allocate = !surfaceLock->pixelBuffer || surfaceLock->width != width || surfaceLock->height != height;
+					EGLBoolean read = preservePixels && (allocate || surfaceLock->dirty);
+
+					// A persistently mapped bitmap, which needs no transfer, is locked without switching contexts.
+					if (allocate || read || !surfaceLock->persistent)
+					{
+						if (!__bindLockContext(walkerDpy, walkerSurface))
+						{
+							g_localStorage.error = EGL_BAD_ACCESS;
+
+							return EGL_FALSE;
+						}
 
-				walkerCtx = walkerCtx->next;
-			}
+						if (allocate)
+						{
+							_eglInternalAllocateSurfaceLock(surfaceLock, width, height);
 
-			g_localStorage.error = EGL_BAD_CONTEXT;
+							surfaceLock->dirty = EGL_TRUE;
+						}
 
-			return EGL_FALSE;
-		}
+						if (read)
+						{
+							_eglInternalReadSurfaceLock(walkerSurface, surfaceLock);
+						}
 
-		walkerDpy = walkerDpy->next;
-	}
+						if (!surfaceLock->persistent)
+						{
+							glBindBuffer(GL_PIXEL_PACK_BUFFER, surfaceLock->pixelBuffer);
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+							surfaceLock->pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)width * (GLsizeiptr)height * 4, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+						}
 
-	return EGL_FALSE;
-}
+						__unbindLockContext(walkerDpy, walkerSurface);
+					}
 
-const char *_eglQueryString(EGLDisplay dpy, EGLint name)
-{
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+					if (!surfaceLock->pixels)
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
 
-	while (walkerDpy)
-	{
-		if ((EGLDisplay)walkerDpy == dpy)
-		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+						return EGL_FALSE;
+					}
 
-				return 0;
-			}
+					surfaceLock->locked = EGL_TRUE;
+					surfaceLock->preservePixels = preservePixels;
+					surfaceLock->usage = usage;
+					surfaceLock->written = EGL_FALSE;
 
-			switch (name)
-			{
-				case EGL_CLIENT_APIS:
-				{
-					return "EGL_OPENGL_API";
-				}
-				break;
-				case EGL_VENDOR:
-				{
-					return _EGL_VENDOR;
-				}
-				break;
-				case EGL_VERSION:
-				{
-					return _EGL_VERSION;
-				}
-				break;
-				case EGL_EXTENSIONS:
-				{
-					return "";
+					return EGL_TRUE;
 				}
-				break;
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			g_localStorage.error = EGL_BAD_PARAMETER;
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			return 0;
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2213,17 +7205,10 @@ const char *_eglQueryString(EGLDisplay dpy, EGLint name)
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return 0;
-}
-
-EGLBoolean _eglQuerySurface (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint *value)
-{
-	// TODO Implement querying a surface.
-
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
+EGLBoolean _eglUnlockSurface(EGLDisplay dpy, EGLSurface surface)
 {
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
@@ -2235,7 +7220,7 @@ EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return 0;
+				return EGL_FALSE;
 			}
 
 			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
@@ -2251,46 +7236,55 @@ EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
 						return EGL_FALSE;
 					}
 
-					return __swapBuffers(walkerDpy, walkerSurface);
-				}
+					EGLSurfaceLockImpl* surfaceLock = &walkerSurface->surfaceLock;
 
-				walkerSurface = walkerSurface->next;
-			}
+					if (!surfaceLock->locked)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-			g_localStorage.error = EGL_BAD_SURFACE;
+						return EGL_FALSE;
+					}
 
-			return EGL_FALSE;
-		}
+					// The whole bitmap is uploaded and blitted, as it is unknown, which pixels the CPU did change. Locks, which did not hand out the pointer for writing, skip this.
+					EGLBoolean write = surfaceLock->written;
 
-		walkerDpy = walkerDpy->next;
-	}
+					// A persistently mapped bitmap, which was not written, needs no GL at all.
+					if (write || !surfaceLock->persistent)
+					{
+						if (!__bindLockContext(walkerDpy, walkerSurface))
+						{
+							g_localStorage.error = EGL_BAD_ACCESS;
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+							return EGL_FALSE;
+						}
 
-	return EGL_FALSE;
-}
+						if (!surfaceLock->persistent)
+						{
+							glBindBuffer(GL_PIXEL_PACK_BUFFER, surfaceLock->pixelBuffer);
+							glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 
-EGLBoolean _eglTerminate(EGLDisplay dpy)
-{
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+							surfaceLock->pixels = 0;
+						}
 
-	while (walkerDpy)
-	{
-		if ((EGLDisplay)walkerDpy == dpy)
-		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_BAD_DISPLAY;
+						if (write)
+						{
+							_eglInternalWriteSurfaceLock(walkerSurface, surfaceLock);
+						}
 
-				return EGL_FALSE;
-			}
+						__unbindLockContext(walkerDpy, walkerSurface);
+					}
 
-			walkerDpy->initialized = EGL_FALSE;
-			walkerDpy->destroy = EGL_TRUE;
+					surfaceLock->locked = EGL_FALSE;
 
-			_eglInternalCleanup();
+					return EGL_TRUE;
+				}
 
-			return EGL_TRUE;
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2301,55 +7295,30 @@ EGLBoolean _eglTerminate(EGLDisplay dpy)
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglWaitNative(EGLint engine)
+//
+// EGL_KHR_lock_surface3
+//
+
+EGLBoolean _eglQuerySurface64(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR* value)
 {
-	if (engine != EGL_CORE_NATIVE_ENGINE)
+	// Only the bitmap pointer may not fit into an EGLint.
+	if (attribute != EGL_BITMAP_POINTER_KHR)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
-
-	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
+		EGLint intValue = 0;
 
-	while (walkerDpy)
-	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if (!_eglQuerySurface(dpy, surface, attribute, &intValue))
 		{
-			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
-			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
-
-				return EGL_FALSE;
-			}
-
-			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
-			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
-
-				return EGL_FALSE;
-			}
-
-			break;
+			return EGL_FALSE;
 		}
 
-		walkerDpy = walkerDpy->next;
-	}
+		if (value)
+		{
+			*value = (EGLAttribKHR)intValue;
+		}
 
-	if (g_localStorage.api == EGL_OPENGL_API)
-	{
-		glFinish();
+		return EGL_TRUE;
 	}
 
-	return EGL_TRUE;
-}
-
-//
-// EGL_VERSION_1_1
-//
-
-EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
-{
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
 
 	while (walkerDpy)
@@ -2358,26 +7327,33 @@ EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
 		{
 			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				g_localStorage.error = EGL_BAD_DISPLAY;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
-			if (walkerDpy->currentDraw == EGL_NO_SURFACE || walkerDpy->currentRead == EGL_NO_SURFACE)
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
 			{
-				g_localStorage.error = EGL_BAD_SURFACE;
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-				return EGL_FALSE;
-			}
+						return EGL_FALSE;
+					}
 
-			if (walkerDpy->currentCtx == EGL_NO_CONTEXT)
-			{
-				g_localStorage.error = EGL_BAD_CONTEXT;
+					return _eglInternalQueryBitmap(walkerSurface, attribute, value);
+				}
 
-				return EGL_FALSE;
+				walkerSurface = walkerSurface->next;
 			}
 
-			return __swapInterval(walkerDpy, interval);
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2389,33 +7365,14 @@ EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
 }
 
 //
-// EGL_VERSION_1_2
+// GL_OES_EGL_image
 //
 
-EGLBoolean _eglBindAPI(EGLenum api)
-{
-	if (api == EGL_OPENGL_API)
-	{
-		g_localStorage.api = api;
-
-		return EGL_TRUE;
-	}
-
-	g_localStorage.error = EGL_BAD_PARAMETER;
-
-	return EGL_FALSE;
-}
-
-EGLenum _eglQueryAPI(void)
-{
-	return g_localStorage.api;
-}
-
-EGLBoolean _eglWaitClient(void)
+void APIENTRY _glEGLImageTargetTexture2DOES(GLenum target, void* image)
 {
 	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
 	{
-		return EGL_TRUE;
+		return;
 	}
 
 	EGLDisplayImpl* walkerDpy = g_localStorage.rootDpy;
@@ -2424,52 +7381,29 @@ EGLBoolean _eglWaitClient(void)
 	{
 		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
 		{
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				return EGL_FALSE;
-			}
+			EGLImageImpl* walkerImage = walkerDpy->rootImage;
 
-			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			while (walkerImage)
 			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
-
-				return EGL_FALSE;
-			}
+				if ((EGLImage)walkerImage == image)
+				{
+					// GL errors can not be raised from here, so failures are reported by eglGetError.
+					if (!walkerImage->initialized || walkerImage->destroy || !__bindImage(walkerDpy, walkerImage, target))
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+					}
 
-			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
-			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+					return;
+				}
 
-				return EGL_FALSE;
+				walkerImage = walkerImage->next;
 			}
 
-			break;
+			g_localStorage.error = EGL_BAD_PARAMETER;
+
+			return;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
-
-	if (g_localStorage.api == EGL_OPENGL_API)
-	{
-		glFinish();
-	}
-
-	return EGL_TRUE;
-}
-
-//
-// EGL_VERSION_1_3
-//
-
-//
-// EGL_VERSION_1_4
-//
-
-EGLContext _eglGetCurrentContext(void)
-{
-	return g_localStorage.currentCtx;
 }
-
-//
-// EGL_VERSION_1_5
-//
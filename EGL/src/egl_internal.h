@@ -45,15 +45,36 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <GL/gl.h>
+#include <GL/glext.h>
 #include "wglext.h"
 #endif  // EGL_NO_GLEW
 
-#define CONTEXT_ATTRIB_LIST_SIZE 13
+#define CONTEXT_ATTRIB_LIST_SIZE 15
+
+typedef struct _NativeDisplayContainer {
+
+	BOOL renderTexture;
+
+	BOOL swapControlTear;
+
+	BOOL contextFlushControl;
+
+	BOOL createContextNoError;
+
+	// Private contexts, which transfer the pixels of locked surfaces. One per pixel format.
+	struct _LockContext* rootLockCtx;
+
+} NativeDisplayContainer;
 
 typedef struct _NativeSurfaceContainer {
 
 	HDC hdc;
 
+	// Lock context of the display, which owns the objects of the locked surface, and the binding it replaces.
+	HGLRC lockCtx;
+	HDC lockPreviousHdc;
+	HGLRC lockPreviousCtx;
+
 } NativeSurfaceContainer;
 
 typedef struct _NativeContextContainer {
@@ -62,6 +83,12 @@ typedef struct _NativeContextContainer {
 
 } NativeContextContainer;
 
+typedef struct _NativeImageContainer {
+
+	HBITMAP bitmap;
+
+} NativeImageContainer;
+
 typedef struct _NativeLocalStorageContainer {
 
 	HWND hwnd;
@@ -85,7 +112,48 @@ typedef struct _NativeLocalStorageContainer {
 #else
 #include <GL/glx.h>
 #endif  // EGL_NO_GLEW
-#define CONTEXT_ATTRIB_LIST_SIZE 10
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#define CONTEXT_ATTRIB_LIST_SIZE 15
+
+typedef struct _NativeDisplayContainer {
+
+	Bool textureFromPixmap;
+
+	Bool sharedMemory;
+
+	Bool copySubBuffer;
+
+	Bool bufferAge;
+
+	Bool swapControl;
+
+	Bool swapControlTear;
+
+	Bool contextFlushControl;
+
+	Bool createContextNoError;
+
+	Bool syncControl;
+
+	// Private connection, which receives the structure events of window surfaces.
+	Display* eventDisplay;
+
+	// Private contexts, which transfer the pixels of locked surfaces. One per configuration.
+	struct _LockContext* rootLockCtx;
+
+} NativeDisplayContainer;
 
 typedef struct _NativeSurfaceContainer {
 
@@ -93,6 +161,29 @@ typedef struct _NativeSurfaceContainer {
 
 	GLXFBConfig config;
 
+	// Backing of a pbuffer, which can be bound as a texture.
+	Pixmap pixmap;
+
+	// Staging image for copying into pixmaps, optionally in shared memory.
+	XImage* image;
+
+	XShmSegmentInfo shmInfo;
+
+	// Pixel buffer of the context, which did the last copy into a pixmap.
+	GLuint copyBuffer;
+	GLsizeiptr copyBufferSize;
+	GLXContext copyCtx;
+
+	// Present thread of the window, if frames are presented asynchronously.
+	struct _PresentQueue* presentQueue;
+
+	// Lock context of the display, which owns the objects of the locked surface, and the binding it replaces.
+	GLXContext lockCtx;
+	Display* lockPreviousDisplay;
+	GLXDrawable lockPreviousDraw;
+	GLXDrawable lockPreviousRead;
+	GLXContext lockPreviousCtx;
+
 } NativeSurfaceContainer;
 
 typedef struct _NativeContextContainer {
@@ -101,6 +192,16 @@ typedef struct _NativeContextContainer {
 
 } NativeContextContainer;
 
+typedef struct _NativeImageContainer {
+
+	GLXPixmap drawable;
+
+	GLXFBConfig config;
+
+	Bool bound;
+
+} NativeImageContainer;
+
 typedef struct _NativeLocalStorageContainer {
 
 	Display* display;
@@ -116,6 +217,26 @@ typedef struct _NativeLocalStorageContainer {
 #endif
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <EGL/egldesktopext.h>
+
+#define EXTENSIONS_STRING_SIZE 1024
+
+#define DAMAGE_RECTS_SIZE 8
+
+#define MAX_SWAP_INTERVAL 8
+
+#define MAX_PRESENT_QUEUE_DEPTH 3
+
+#define MAX_FRAMES_IN_FLIGHT 8
+
+#define FRAME_TIMESTAMPS_SIZE 16
+
+#define FRAME_EXPORT_RING_SIZE 3
+
+#define FRAME_RING_DEFAULT_SLOTS 4
+
+#define FRAME_RING_DEFAULT_TIMEOUT 1000
 
 //
 
@@ -164,6 +285,9 @@ typedef struct _EGLConfigImpl
 	// Returns the number of bits of luminance stored in the luminance buffer.
 	EGLint luminanceSize;
 
+	// Returns the format of the bitmap of a locked surface. EGL_NONE, if surfaces of the configuration can not be locked.
+	EGLint matchFormat;
+
 	// Input only: Must be followed by the handle of a valid native pixmap, cast to EGLint, or EGL_NONE.
 	EGLint matchNativePixmap;
 
@@ -232,6 +356,121 @@ typedef struct _EGLConfigImpl
 
 } EGLConfigImpl;
 
+typedef struct _EGLFrameTimestampsImpl
+{
+
+	EGLuint64KHR frameId;
+
+	EGLnsecsANDROID swapRequestedTime;
+	EGLnsecsANDROID renderingCompleteTime;
+	EGLnsecsANDROID displayPresentTime;
+
+	// Signaled, when rendering of the frame is complete.
+	GLsync renderingCompleteFence;
+
+	// Swap counter of the window, after the frame is presented.
+	EGLuint64KHR presentCounter;
+
+} EGLFrameTimestampsImpl;
+
+typedef struct _EGLFrameExportImpl
+{
+
+	// Ring of pixel buffers, which are read back asynchronously. Each readback is guarded by a fence.
+	GLuint pixelBuffers[FRAME_EXPORT_RING_SIZE];
+	GLsync fences[FRAME_EXPORT_RING_SIZE];
+	EGLuint64KHR frameIds[FRAME_EXPORT_RING_SIZE];
+
+	EGLint width;
+	EGLint height;
+	EGLint pitch;
+
+	// Layout of the frames. Frames, which are not RGBA, are converted on the GPU before the readback.
+	EGLint format;
+	GLsizeiptr size;
+
+	// Objects of the color conversion, which are private to the context.
+	GLuint program;
+	GLint sizeLocation;
+	GLint planarLocation;
+	GLuint vertexArray;
+	GLuint framebuffer;
+	GLuint sourceTexture;
+	GLuint targetTexture;
+
+	// The shaders are not compiled again for the context, if this did fail once.
+	EGLBoolean colorConversionFailed;
+
+	// Slot of the next readback, which is also the oldest one.
+	EGLint next;
+
+	// Slot, which is mapped for the application until the next swap. Otherwise -1.
+	EGLint mapped;
+	void* pixels;
+
+	EGLuint64KHR nextFrameId;
+
+	struct _EGLContextImpl* ctx;
+
+} EGLFrameExportImpl;
+
+typedef struct _EGLFrameRingImpl
+{
+
+	// Memory shared with the consumer, which starts with the header. Otherwise, no ring is bound.
+	EGLFrameRingDESKTOP* header;
+	size_t size;
+	EGLint fd;
+
+	// Larger frames are cropped.
+	EGLint maxWidth;
+	EGLint maxHeight;
+
+	// Milliseconds to wait for a free slot, before a frame is dropped.
+	EGLint timeout;
+
+	// Frames, which are read back by the GPU but not yet published. They follow the written frames.
+	EGLint pending;
+	GLsync fences[EGL_FRAME_RING_MAX_SLOTS_DESKTOP];
+
+	// Slots wrapped as pixel buffers, so the GPU writes directly into the shared memory. Otherwise, pixels are read synchronously.
+	GLuint pixelBuffers[EGL_FRAME_RING_MAX_SLOTS_DESKTOP];
+
+	EGLuint64KHR nextFrameId;
+
+	struct _EGLContextImpl* ctx;
+
+} EGLFrameRingImpl;
+
+typedef struct _EGLSurfaceLockImpl
+{
+
+	// Set between eglLockSurfaceKHR and eglUnlockSurfaceKHR, together with the given attributes.
+	EGLBoolean locked;
+	EGLBoolean preservePixels;
+	EGLint usage;
+
+	// Set, when the bitmap pointer is queried by a lock for writing. Only then the CPU can have changed pixels, which are uploaded on unlock.
+	EGLBoolean written;
+
+	// Bitmap in a pixel buffer of the private lock context. It stays mapped, if the storage of the buffer is persistent.
+	GLuint pixelBuffer;
+	EGLBoolean persistent;
+	void* pixels;
+	EGLint width;
+	EGLint height;
+
+	// Bitmap is blitted to the color buffer through a texture.
+	GLuint texture;
+	GLuint framebuffer;
+	EGLint textureWidth;
+	EGLint textureHeight;
+
+	// Color buffer may differ from the bitmap, as it was rendered to or swapped.
+	EGLBoolean dirty;
+
+} EGLSurfaceLockImpl;
+
 typedef struct _EGLSurfaceImpl
 {
 
@@ -244,7 +483,75 @@ typedef struct _EGLSurfaceImpl
 	EGLBoolean doubleBuffer;
 	EGLint configId;
 
+	// Buffer, the client API renders to. A requested change of a mutable render buffer is applied at the next swap.
+	EGLBoolean mutableRenderBuffer;
+	EGLint renderBuffer;
+	EGLint requestedRenderBuffer;
+
+	// Cached size, kept up to date by the platform.
+	EGLint width;
+	EGLint height;
+
+	EGLint swapBehavior;
+	EGLint multisampleResolve;
+	EGLint mipmapLevel;
+
+	// Interval of the window, which is set natively only when changed or not yet applied.
+	EGLint swapInterval;
+
+	// Frame is not presented before this monotonic time in nanoseconds. Zero presents as soon as possible.
+	EGLnsecsANDROID presentationTime;
+
+	// Frames, which can be queued for the present thread. Zero presents on the calling thread.
+	EGLint presentQueueDepth;
+
+	// Fences of the frames, which may still be rendered by the GPU. Zero frames means no limit.
+	EGLint maxFramesInFlight;
+	GLsync frameFences[MAX_FRAMES_IN_FLIGHT];
+	EGLint frameFencesFirst;
+	EGLint frameFencesCount;
+	struct _EGLContextImpl* frameFencesCtx;
+
+	// Timestamps of the latest frames, if enabled.
+	EGLBoolean timestamps;
+	EGLFrameTimestampsImpl frameTimestamps[FRAME_TIMESTAMPS_SIZE];
+	EGLuint64KHR nextFrameId;
+	EGLuint64KHR nextPresentCounter;
+	EGLBoolean presentCounterKnown;
+	struct _EGLContextImpl* timestampsCtx;
+
+	// Frames of a swap group are held, until all windows of the group have been swapped. Zero is no group.
+	EGLint swapGroup;
+	EGLBoolean swapGroupPending;
+
+	// Frames are read back on swap, if enabled.
+	EGLBoolean exportFrames;
+	EGLint exportFormat;
+	EGLFrameExportImpl frameExport;
+
+	// Frames are written to the ring of a consumer process on swap, if bound.
+	EGLFrameRingImpl frameRing;
+
+	// Bitmap, which is mapped for the CPU while the surface is locked.
+	EGLSurfaceLockImpl surfaceLock;
+
+	// Age of the back buffer, if known by the library. Otherwise 0.
+	EGLint bufferAge;
+	EGLBoolean bufferAgeQueried;
+
+	// Region of the current frame, given by eglSetDamageRegionKHR. No rectangles means the whole surface.
+	EGLBoolean damageRegionSet;
+	EGLint damageRects[DAMAGE_RECTS_SIZE * 4];
+	EGLint damageRectsCount;
+
+	EGLint textureFormat;
+	EGLint textureTarget;
+	EGLBoolean mipmapTexture;
+	EGLBoolean largestPBuffer;
+	EGLBoolean textureBound;
+
 	EGLNativeWindowType win;
+	EGLNativePixmapType pixmap;
 
 	NativeSurfaceContainer nativeSurfaceContainer;
 
@@ -259,6 +566,13 @@ typedef struct _EGLContextListImpl
 
 	NativeContextContainer nativeContextContainer;
 
+	// WGL keeps the swap interval per context and GLX per drawable, so it is tracked per pair.
+	EGLint swapInterval;
+	EGLBoolean swapIntervalApplied;
+
+	// Render buffer, which the draw buffer of the context was last set to. EGL_NONE, if not set yet.
+	EGLint renderBufferApplied;
+
 	struct _EGLContextListImpl* next;
 
 } EGLContextListImpl;
@@ -277,10 +591,30 @@ typedef struct _EGLContextImpl
 
 	EGLint attribList[CONTEXT_ATTRIB_LIST_SIZE];
 
+	// Requested priority. Neither GLX nor WGL can pass a priority, so it is only a hint.
+	EGLint priority;
+
 	struct _EGLContextImpl* next;
 
 } EGLContextImpl;
 
+typedef struct _EGLImageImpl
+{
+
+	EGLBoolean initialized;
+	EGLBoolean destroy;
+
+	EGLenum target;
+
+	EGLint width;
+	EGLint height;
+
+	NativeImageContainer nativeImageContainer;
+
+	struct _EGLImageImpl* next;
+
+} EGLImageImpl;
+
 typedef struct _EGLDisplayImpl
 {
 
@@ -289,14 +623,26 @@ typedef struct _EGLDisplayImpl
 
 	EGLNativeDisplayType display_id;
 
+	NativeDisplayContainer nativeDisplayContainer;
+
+	char extensions[EXTENSIONS_STRING_SIZE];
+
 	EGLSurfaceImpl* rootSurface;
 	EGLContextImpl* rootCtx;
 	EGLConfigImpl* rootConfig;
+	EGLImageImpl* rootImage;
 
 	EGLSurfaceImpl* currentDraw;
 	EGLSurfaceImpl* currentRead;
 	EGLContextImpl* currentCtx;
 
+	// Handles are trusted, see EGL_DESKTOP_no_validation.
+	EGLBoolean noValidation;
+
+	// Statistics of EGL_DESKTOP_display_statistics.
+	EGLAttrib makeCurrentCalls;
+	EGLAttrib makeCurrentSkipped;
+
 	struct _EGLDisplayImpl* next;
 
 } EGLDisplayImpl;
@@ -320,6 +666,8 @@ typedef struct _LocalStorage
 
 void _eglInternalSetDefaultConfig(EGLConfigImpl* config);
 
+void _eglInternalAddExtension(EGLDisplayImpl* walkerDpy, const char* extension);
+
 //
 
 EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContainer);
@@ -328,22 +676,66 @@ EGLBoolean __internalTerminate(NativeLocalStorageContainer* nativeLocalStorageCo
 
 EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextContainer* nativeContextContainer);
 
-EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, EGLint* error);
+EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, const EGLDisplayImpl* walkerDpy, EGLint* error);
 
 EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType win, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
 
-EGLBoolean __destroySurface(EGLNativeWindowType win, const NativeSurfaceContainer* nativeSurfaceContainer);
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
+
+EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
+
+EGLBoolean __destroySurface(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
 
 __eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname);
 
+EGLBoolean __updateSurfaceSize(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
+
 EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageContainer* nativeLocalStorageContainer, EGLint* error);
 
+EGLBoolean __terminate(EGLDisplayImpl* walkerDpy);
+
 EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList);
 
 EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer);
 
-EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface);
+EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
+
+EGLBoolean __swapBuffersWithDamage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects);
+
+EGLBoolean __flushSwaps(const EGLDisplayImpl* walkerDpy);
+
+EGLint __queryBufferAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface);
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval);
+
+EGLBoolean __hasPresentQueue(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface);
+
+EGLnsecsANDROID __getMonotonicTime(void);
+
+EGLBoolean __getPresentCounter(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* counter, EGLnsecsANDROID* time);
+
+EGLBoolean __createImage(EGLImageImpl* newImage, EGLenum target, EGLClientBuffer buffer, const EGLDisplayImpl* walkerDpy, EGLint* error);
+
+EGLBoolean __destroyImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage);
+
+EGLBoolean __bindImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage, GLenum target);
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error);
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
+
+EGLBoolean __createFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint slotCount, size_t slotSize, EGLint* error);
+
+EGLBoolean __destroyFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing);
+
+EGLBoolean __waitFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint timeout);
+
+EGLBoolean __publishFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing);
+
+EGLBoolean __bindLockContext(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval);
+EGLBoolean __unbindLockContext(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface);
 
 #endif /* EGL_INTERNAL_H_ */
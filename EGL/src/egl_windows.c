@@ -28,15 +28,100 @@
 
 #if defined(EGL_NO_GLEW)
 typedef void(*__PFN_glFinish)();
+typedef GLsync (*__PFN_glFenceSync)(GLenum, GLbitfield);
+typedef GLenum (*__PFN_glClientWaitSync)(GLsync, GLbitfield, GLuint64);
+typedef void (*__PFN_glDeleteSync)(GLsync);
+typedef void (*__PFN_glGenBuffers)(GLsizei, GLuint*);
+typedef void (*__PFN_glDeleteBuffers)(GLsizei, const GLuint*);
+typedef void (*__PFN_glBindBuffer)(GLenum, GLuint);
+typedef void (*__PFN_glBufferData)(GLenum, GLsizeiptr, const void*, GLenum);
+typedef void* (*__PFN_glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+typedef GLboolean (*__PFN_glUnmapBuffer)(GLenum);
+typedef void (*__PFN_glBindFramebuffer)(GLenum, GLuint);
+typedef GLuint (*__PFN_glCreateShader)(GLenum);
+typedef void (*__PFN_glShaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+typedef void (*__PFN_glCompileShader)(GLuint);
+typedef void (*__PFN_glGetShaderiv)(GLuint, GLenum, GLint*);
+typedef void (*__PFN_glDeleteShader)(GLuint);
+typedef GLuint (*__PFN_glCreateProgram)(void);
+typedef void (*__PFN_glAttachShader)(GLuint, GLuint);
+typedef void (*__PFN_glLinkProgram)(GLuint);
+typedef void (*__PFN_glGetProgramiv)(GLuint, GLenum, GLint*);
+typedef void (*__PFN_glDeleteProgram)(GLuint);
+typedef void (*__PFN_glUseProgram)(GLuint);
+typedef GLint (*__PFN_glGetUniformLocation)(GLuint, const GLchar*);
+typedef void (*__PFN_glUniform1i)(GLint, GLint);
+typedef void (*__PFN_glUniform2i)(GLint, GLint, GLint);
+typedef void (*__PFN_glActiveTexture)(GLenum);
+typedef void (*__PFN_glGenFramebuffers)(GLsizei, GLuint*);
+typedef void (*__PFN_glDeleteFramebuffers)(GLsizei, const GLuint*);
+typedef void (*__PFN_glFramebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+typedef void (*__PFN_glGenVertexArrays)(GLsizei, GLuint*);
+typedef void (*__PFN_glBindVertexArray)(GLuint);
+typedef void (*__PFN_glDeleteVertexArrays)(GLsizei, const GLuint*);
+typedef void (*__PFN_glBindSampler)(GLuint, GLuint);
+typedef const GLubyte* (*__PFN_glGetStringi)(GLenum, GLuint);
+typedef void (*__PFN_glBlitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+typedef void (*__PFN_glBufferStorage)(GLenum, GLsizeiptr, const void*, GLbitfield);
+typedef void (*__PFN_glAddSwapHintRectWIN)(GLint, GLint, GLsizei, GLsizei);
 
 __PFN_glFinish glFinish_PTR = NULL;
+__PFN_glFenceSync glFenceSync_PTR = NULL;
+__PFN_glClientWaitSync glClientWaitSync_PTR = NULL;
+__PFN_glDeleteSync glDeleteSync_PTR = NULL;
+__PFN_glGenBuffers glGenBuffers_PTR = NULL;
+__PFN_glDeleteBuffers glDeleteBuffers_PTR = NULL;
+__PFN_glBindBuffer glBindBuffer_PTR = NULL;
+__PFN_glBufferData glBufferData_PTR = NULL;
+__PFN_glMapBufferRange glMapBufferRange_PTR = NULL;
+__PFN_glUnmapBuffer glUnmapBuffer_PTR = NULL;
+__PFN_glBindFramebuffer glBindFramebuffer_PTR = NULL;
+__PFN_glCreateShader glCreateShader_PTR = NULL;
+__PFN_glShaderSource glShaderSource_PTR = NULL;
+__PFN_glCompileShader glCompileShader_PTR = NULL;
+__PFN_glGetShaderiv glGetShaderiv_PTR = NULL;
+__PFN_glDeleteShader glDeleteShader_PTR = NULL;
+__PFN_glCreateProgram glCreateProgram_PTR = NULL;
+__PFN_glAttachShader glAttachShader_PTR = NULL;
+__PFN_glLinkProgram glLinkProgram_PTR = NULL;
+__PFN_glGetProgramiv glGetProgramiv_PTR = NULL;
+__PFN_glDeleteProgram glDeleteProgram_PTR = NULL;
+__PFN_glUseProgram glUseProgram_PTR = NULL;
+__PFN_glGetUniformLocation glGetUniformLocation_PTR = NULL;
+__PFN_glUniform1i glUniform1i_PTR = NULL;
+__PFN_glUniform2i glUniform2i_PTR = NULL;
+__PFN_glActiveTexture glActiveTexture_PTR = NULL;
+__PFN_glGenFramebuffers glGenFramebuffers_PTR = NULL;
+__PFN_glDeleteFramebuffers glDeleteFramebuffers_PTR = NULL;
+__PFN_glFramebufferTexture2D glFramebufferTexture2D_PTR = NULL;
+__PFN_glGenVertexArrays glGenVertexArrays_PTR = NULL;
+__PFN_glBindVertexArray glBindVertexArray_PTR = NULL;
+__PFN_glDeleteVertexArrays glDeleteVertexArrays_PTR = NULL;
+__PFN_glBindSampler glBindSampler_PTR = NULL;
+__PFN_glGetStringi glGetStringi_PTR = NULL;
+__PFN_glBlitFramebuffer glBlitFramebuffer_PTR = NULL;
+__PFN_glBufferStorage glBufferStorage_PTR = NULL;
+__PFN_glAddSwapHintRectWIN glAddSwapHintRectWIN_PTR = NULL;
 PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB = NULL;
 PFNWGLGETPIXELFORMATATTRIBIVARBPROC wglGetPixelFormatAttribivARB = NULL;
 PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = NULL;
 PFNWGLGETEXTENSIONSSTRINGARBPROC wglGetExtensionsStringARB = NULL;
 PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT = NULL;
+
+#define glBindBuffer(...) glBindBuffer_PTR(__VA_ARGS__)
+#define glAddSwapHintRectWIN(...) glAddSwapHintRectWIN_PTR(__VA_ARGS__)
 #endif
 
+// A context can only be bound to device contexts of the same pixel format, so the locked surfaces of a display share one per pixel format.
+typedef struct _LockContext {
+
+	int pixelFormat;
+
+	HGLRC ctx;
+
+	struct _LockContext* next;
+
+} LockContext;
 
 static LRESULT CALLBACK __DummyWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
@@ -202,6 +287,62 @@ EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContain
       (PFNWGLGETEXTENSIONSSTRINGARBPROC)
       __getProcAddress("wglGetExtensionsStringARB");
 	glFinish_PTR = (__PFN_glFinish)__getProcAddress("glFinish");
+	glFenceSync_PTR = (__PFN_glFenceSync)__getProcAddress("glFenceSync");
+	glClientWaitSync_PTR =
+      (__PFN_glClientWaitSync)__getProcAddress("glClientWaitSync");
+	glDeleteSync_PTR = (__PFN_glDeleteSync)__getProcAddress("glDeleteSync");
+	glGenBuffers_PTR = (__PFN_glGenBuffers)__getProcAddress("glGenBuffers");
+	glDeleteBuffers_PTR =
+      (__PFN_glDeleteBuffers)__getProcAddress("glDeleteBuffers");
+	glBindBuffer_PTR = (__PFN_glBindBuffer)__getProcAddress("glBindBuffer");
+	glBufferData_PTR = (__PFN_glBufferData)__getProcAddress("glBufferData");
+	glMapBufferRange_PTR =
+      (__PFN_glMapBufferRange)__getProcAddress("glMapBufferRange");
+	glUnmapBuffer_PTR = (__PFN_glUnmapBuffer)__getProcAddress("glUnmapBuffer");
+	glBindFramebuffer_PTR =
+      (__PFN_glBindFramebuffer)__getProcAddress("glBindFramebuffer");
+	glCreateShader_PTR = (__PFN_glCreateShader)__getProcAddress("glCreateShader");
+	glShaderSource_PTR = (__PFN_glShaderSource)__getProcAddress("glShaderSource");
+	glCompileShader_PTR =
+      (__PFN_glCompileShader)__getProcAddress("glCompileShader");
+	glGetShaderiv_PTR = (__PFN_glGetShaderiv)__getProcAddress("glGetShaderiv");
+	glDeleteShader_PTR = (__PFN_glDeleteShader)__getProcAddress("glDeleteShader");
+	glCreateProgram_PTR =
+      (__PFN_glCreateProgram)__getProcAddress("glCreateProgram");
+	glAttachShader_PTR = (__PFN_glAttachShader)__getProcAddress("glAttachShader");
+	glLinkProgram_PTR = (__PFN_glLinkProgram)__getProcAddress("glLinkProgram");
+	glGetProgramiv_PTR = (__PFN_glGetProgramiv)__getProcAddress("glGetProgramiv");
+	glDeleteProgram_PTR =
+      (__PFN_glDeleteProgram)__getProcAddress("glDeleteProgram");
+	glUseProgram_PTR = (__PFN_glUseProgram)__getProcAddress("glUseProgram");
+	glGetUniformLocation_PTR =
+      (__PFN_glGetUniformLocation)__getProcAddress("glGetUniformLocation");
+	glUniform1i_PTR = (__PFN_glUniform1i)__getProcAddress("glUniform1i");
+	glUniform2i_PTR = (__PFN_glUniform2i)__getProcAddress("glUniform2i");
+	glActiveTexture_PTR =
+      (__PFN_glActiveTexture)__getProcAddress("glActiveTexture");
+	glGenFramebuffers_PTR =
+      (__PFN_glGenFramebuffers)__getProcAddress("glGenFramebuffers");
+	glDeleteFramebuffers_PTR =
+      (__PFN_glDeleteFramebuffers)__getProcAddress("glDeleteFramebuffers");
+	glFramebufferTexture2D_PTR =
+      (__PFN_glFramebufferTexture2D)__getProcAddress("glFramebufferTexture2D");
+	glGenVertexArrays_PTR =
+      (__PFN_glGenVertexArrays)__getProcAddress("glGenVertexArrays");
+	glBindVertexArray_PTR =
+      (__PFN_glBindVertexArray)__getProcAddress("glBindVertexArray");
+	glDeleteVertexArrays_PTR =
+      (__PFN_glDeleteVertexArrays)__getProcAddress("glDeleteVertexArrays");
+	glBindSampler_PTR =
+      (__PFN_glBindSampler)__getProcAddress("glBindSampler");
+	glGetStringi_PTR =
+      (__PFN_glGetStringi)__getProcAddress("glGetStringi");
+	glBlitFramebuffer_PTR =
+      (__PFN_glBlitFramebuffer)__getProcAddress("glBlitFramebuffer");
+	glBufferStorage_PTR =
+      (__PFN_glBufferStorage)__getProcAddress("glBufferStorage");
+	glAddSwapHintRectWIN_PTR =
+      (__PFN_glAddSwapHintRectWIN)__getProcAddress("glAddSwapHintRectWIN");
 #endif
 	return EGL_TRUE;
 }
@@ -248,9 +389,9 @@ EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextC
 	return wglDeleteContext(nativeContextContainer->ctx);
 }
 
-EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, EGLint* error)
+EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, const EGLDisplayImpl* walkerDpy, EGLint* error)
 {
-	if (!target_attrib_list || !attrib_list || !error)
+	if (!target_attrib_list || !attrib_list || !walkerDpy || !error)
 	{
 		return EGL_FALSE;
 	}
@@ -262,9 +403,17 @@ EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_
 			WGL_CONTEXT_FLAGS_ARB, 0,
 			WGL_CONTEXT_PROFILE_MASK_ARB, 0,
 			WGL_CONTEXT_RESET_NOTIFICATION_STRATEGY_ARB, WGL_NO_RESET_NOTIFICATION_ARB,
+			// Optional attributes, only passed when set.
+			0, 0,
+			0, 0,
 			0
 	};
 
+	EGLBoolean releaseBehaviorSet = EGL_FALSE;
+	EGLint releaseBehavior = 0;
+
+	EGLBoolean noError = EGL_FALSE;
+
 	EGLint attribListIndex = 0;
 
 	while (attrib_list[attribListIndex] != EGL_NONE)
@@ -387,6 +536,68 @@ EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_
 				}
 			}
 			break;
+			case EGL_CONTEXT_RELEASE_BEHAVIOR_KHR:
+			{
+				if (!walkerDpy->nativeDisplayContainer.contextFlushControl)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				if (value == EGL_CONTEXT_RELEASE_BEHAVIOR_NONE_KHR)
+				{
+					releaseBehavior = WGL_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB;
+				}
+				else if (value == EGL_CONTEXT_RELEASE_BEHAVIOR_FLUSH_KHR)
+				{
+					releaseBehavior = WGL_CONTEXT_RELEASE_BEHAVIOR_FLUSH_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				releaseBehaviorSet = EGL_TRUE;
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_NO_ERROR_KHR:
+			{
+				if (!walkerDpy->nativeDisplayContainer.createContextNoError)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				if (value == EGL_TRUE)
+				{
+					noError = EGL_TRUE;
+				}
+				else if (value == EGL_FALSE)
+				{
+					noError = EGL_FALSE;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+			{
+				if (value != EGL_CONTEXT_PRIORITY_HIGH_IMG && value != EGL_CONTEXT_PRIORITY_MEDIUM_IMG && value != EGL_CONTEXT_PRIORITY_LOW_IMG)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
 			default:
 			{
 				*error = EGL_BAD_ATTRIBUTE;
@@ -398,8 +609,8 @@ EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_
 
 		attribListIndex += 2;
 
-		// More than 14 entries can not exist.
-		if (attribListIndex >= 7 * 2)
+		// More than 20 entries can not exist.
+		if (attribListIndex >= 10 * 2)
 		{
 			*error = EGL_BAD_ATTRIBUTE;
 
@@ -407,6 +618,29 @@ EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_
 		}
 	}
 
+	// Errors can not be reported by a no error context.
+	if (noError && (template_attrib_list[7] & (WGL_CONTEXT_DEBUG_BIT_ARB | WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB)))
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	// Optional attributes are appended, as older drivers do not know them.
+	EGLint optionalIndex = 12;
+
+	if (releaseBehaviorSet)
+	{
+		template_attrib_list[optionalIndex++] = WGL_CONTEXT_RELEASE_BEHAVIOR_ARB;
+		template_attrib_list[optionalIndex++] = releaseBehavior;
+	}
+
+	if (noError)
+	{
+		template_attrib_list[optionalIndex++] = WGL_CONTEXT_OPENGL_NO_ERROR_ARB;
+		template_attrib_list[optionalIndex++] = TRUE;
+	}
+
 	memcpy(target_attrib_list, template_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
 
 	return EGL_TRUE;
@@ -428,6 +662,8 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 		return EGL_FALSE;
 	}
 
+	EGLint renderBuffer = EGL_BACK_BUFFER;
+
 	// FIXME Check more values.
 	EGLint template_attrib_list[] = {
 			WGL_DRAW_TO_WINDOW_ARB, GL_TRUE,
@@ -484,7 +720,8 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 				{
 					if (value == EGL_SINGLE_BUFFER)
 					{
-						template_attrib_list[7] = GL_FALSE;
+						// A mutable render buffer stays double buffered and renders to the front buffer.
+						template_attrib_list[7] = (walkerConfig->surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR) ? GL_TRUE : GL_FALSE;
 					}
 					else if (value == EGL_BACK_BUFFER)
 					{
@@ -498,6 +735,8 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 
 						return EGL_FALSE;
 					}
+
+					renderBuffer = value;
 				}
 				break;
 				case EGL_VG_ALPHA_FORMAT:
@@ -593,26 +832,61 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 
 	newSurface->drawToWindow = EGL_TRUE;
 	newSurface->drawToPixmap = EGL_FALSE;
-	newSurface->drawToPixmap = EGL_FALSE;
+	newSurface->drawToPBuffer = EGL_FALSE;
 	newSurface->doubleBuffer = (EGLBoolean)template_attrib_list[7];
 	newSurface->configId = wgl_formats;
 
+	newSurface->mutableRenderBuffer = (walkerConfig->surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR) ? EGL_TRUE : EGL_FALSE;
+	newSurface->renderBuffer = newSurface->doubleBuffer ? renderBuffer : EGL_SINGLE_BUFFER;
+	newSurface->requestedRenderBuffer = newSurface->renderBuffer;
+
 	newSurface->initialized = EGL_TRUE;
 	newSurface->destroy = EGL_FALSE;
 	newSurface->win = win;
 	newSurface->nativeSurfaceContainer.hdc = hdc;
 
+	__updateSurfaceSize(walkerDpy, newSurface);
+
 	return EGL_TRUE;
 }
 
-EGLBoolean __destroySurface(EGLNativeWindowType win, const NativeSurfaceContainer* nativeSurfaceContainer)
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	// No configuration can draw to pixmaps, so this is not reached by a valid configuration.
+	*error = EGL_BAD_MATCH;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
 {
-	if (!nativeSurfaceContainer)
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
 	{
 		return EGL_FALSE;
 	}
 
-	ReleaseDC(win, nativeSurfaceContainer->hdc);
+	// No configuration can draw to pbuffers, so this is not reached by a valid configuration.
+	*error = EGL_BAD_MATCH;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroySurface(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// The lock context is shared with other surfaces and deleted together with the display.
+	walkerSurface->nativeSurfaceContainer.lockCtx = 0;
+
+	ReleaseDC(walkerSurface->win, walkerSurface->nativeSurfaceContainer.hdc);
 
 	return EGL_TRUE;
 }
@@ -622,6 +896,27 @@ __eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname)
 	return (__eglMustCastToProperFunctionPointerType )wglGetProcAddress(procname);
 }
 
+EGLBoolean __updateSurfaceSize(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// Reading the client rectangle does not involve a round trip.
+	RECT rect;
+
+	if (!GetClientRect(walkerSurface->win, &rect))
+	{
+		return EGL_FALSE;
+	}
+
+	walkerSurface->width = (EGLint)(rect.right - rect.left);
+	walkerSurface->height = (EGLint)(rect.bottom - rect.top);
+
+	return EGL_TRUE;
+}
+
 EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageContainer* nativeLocalStorageContainer, EGLint* error)
 {
 	if (!walkerDpy || !nativeLocalStorageContainer || !error)
@@ -644,6 +939,24 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
   int render_texture_supported = strstr(wglGetExtensionsStringARB(nativeLocalStorageContainer->hdc),
 		                                  "WGL_ARB_render_texture") != NULL;
 
+	walkerDpy->nativeDisplayContainer.renderTexture = render_texture_supported;
+
+	walkerDpy->nativeDisplayContainer.swapControlTear = strstr(wglGetExtensionsStringARB(nativeLocalStorageContainer->hdc), "WGL_EXT_swap_control_tear") != NULL;
+
+	walkerDpy->nativeDisplayContainer.contextFlushControl = strstr(wglGetExtensionsStringARB(nativeLocalStorageContainer->hdc), "WGL_ARB_context_flush_control") != NULL;
+
+	if (walkerDpy->nativeDisplayContainer.contextFlushControl)
+	{
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_context_flush_control");
+	}
+
+	walkerDpy->nativeDisplayContainer.createContextNoError = strstr(wglGetExtensionsStringARB(nativeLocalStorageContainer->hdc), "WGL_ARB_create_context_no_error") != NULL;
+
+	if (walkerDpy->nativeDisplayContainer.createContextNoError)
+	{
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_create_context_no_error");
+	}
+
   EGLConfigImpl* lastConfig = 0;
 	for (EGLint currentPixelFormat = 1; currentPixelFormat <= numberPixelFormats; currentPixelFormat++)
 	{
@@ -706,14 +1019,6 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 			return EGL_FALSE;
 		}
 
-		attribute = WGL_DRAW_TO_BITMAP_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->drawToPixmap))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
 		attribute = WGL_DOUBLE_BUFFER_ARB;
 		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->doubleBuffer))
 		{
@@ -724,6 +1029,8 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 		//
 
+		// Pixmap and pbuffer surfaces are not supported on Windows.
+		newConfig->drawToPixmap = EGL_FALSE;
 		newConfig->drawToPBuffer = EGL_FALSE;
 
 		newConfig->conformant = EGL_OPENGL_BIT;
@@ -741,9 +1048,17 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 		{
 			newConfig->surfaceType |= EGL_PBUFFER_BIT;
 		}
+		// Rendering to the front buffer of a double buffered window is done by changing the draw buffer.
+		if (newConfig->drawToWindow && newConfig->doubleBuffer)
+		{
+			newConfig->surfaceType |= EGL_MUTABLE_RENDER_BUFFER_BIT_KHR;
+		}
 		newConfig->colorBufferType = EGL_RGB_BUFFER;
 		newConfig->configId = currentPixelFormat;
 
+		newConfig->minSwapInterval = 0;
+		newConfig->maxSwapInterval = MAX_SWAP_INTERVAL;
+
 		attribute = WGL_COLOR_BITS_ARB;
 		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->bufferSize))
 		{
@@ -819,6 +1134,15 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 			return EGL_FALSE;
 		}
 
+		// The bitmap of a locked surface is blitted back, which is not possible into a multisampled color buffer.
+		if (newConfig->sampleBuffers == 0)
+		{
+			newConfig->surfaceType |= EGL_LOCK_SURFACE_BIT_KHR;
+
+			// Pixels are converted to 32 bits by the GL, which is exact for 8 bits per component.
+			newConfig->matchFormat = (newConfig->redSize == 8 && newConfig->greenSize == 8 && newConfig->blueSize == 8 && newConfig->alphaSize == 8) ? EGL_FORMAT_RGBA_8888_EXACT_KHR : EGL_FORMAT_RGBA_8888_KHR;
+		}
+
 		//
 
 		attribute = WGL_BIND_TO_TEXTURE_RGB_ARB;
@@ -908,6 +1232,31 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 	return EGL_TRUE;
 }
 
+EGLBoolean __terminate(EGLDisplayImpl* walkerDpy)
+{
+	if (!walkerDpy)
+	{
+		return EGL_FALSE;
+	}
+
+	// Objects of surfaces, which were not destroyed, are released together with the lock contexts.
+	LockContext* lockCtx = walkerDpy->nativeDisplayContainer.rootLockCtx;
+
+	while (lockCtx)
+	{
+		LockContext* nextLockCtx = lockCtx->next;
+
+		wglDeleteContext(lockCtx->ctx);
+		free(lockCtx);
+
+		lockCtx = nextLockCtx;
+	}
+
+	walkerDpy->nativeDisplayContainer.rootLockCtx = 0;
+
+	return EGL_TRUE;
+}
+
 EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeSurfaceContainer, const EGLint* attribList)
 {
 	if (!walkerDpy || !nativeContextContainer || !nativeSurfaceContainer)
@@ -930,22 +1279,430 @@ EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceCon
 	return (EGLBoolean)wglMakeCurrent(nativeSurfaceContainer->hdc, nativeContextContainer->ctx);
 }
 
-EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
 {
 	if (!walkerDpy || !walkerSurface)
 	{
 		return EGL_FALSE;
 	}
 
+	EGLnsecsANDROID delay = walkerSurface->presentationTime - __getMonotonicTime();
+
+	// Without a counter of vertical blanks, the swap is only delayed until the time. Sleep is rounded up to milliseconds.
+	if (walkerSurface->presentationTime > 0 && delay > 0)
+	{
+		Sleep((DWORD)((delay + 999999) / 1000000));
+	}
+
+	// Content of a new back buffer is unknown, but single buffers always keep it.
+	walkerSurface->bufferAge = walkerSurface->doubleBuffer ? 0 : 1;
+
 	return (EGLBoolean)SwapBuffers(walkerSurface->nativeSurfaceContainer.hdc);
 }
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+EGLBoolean __swapBuffersWithDamage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+	if (!walkerDpy || !walkerSurface || !rects)
+	{
+		return EGL_FALSE;
+	}
+
+	// Without GL_WIN_swap_hint, the whole surface is swapped, which is allowed, as damage is only a hint.
+#if defined(EGL_NO_GLEW)
+	if (glAddSwapHintRectWIN_PTR)
+#else
+	if (glAddSwapHintRectWIN)
+#endif
+	{
+		EGLint i;
+
+		// Both use the lower left corner as origin. The hints are reset by the swap.
+		for (i = 0; i < n_rects; i++)
+		{
+			glAddSwapHintRectWIN(rects[i * 4 + 0], rects[i * 4 + 1], rects[i * 4 + 2], rects[i * 4 + 3]);
+		}
+	}
+
+	return __swapBuffers(walkerDpy, walkerSurface);
+}
+
+EGLBoolean __flushSwaps(const EGLDisplayImpl* walkerDpy)
 {
 	if (!walkerDpy)
 	{
 		return EGL_FALSE;
 	}
 
+	// SwapBuffers is not buffered, so there is nothing to flush.
+
+	return EGL_TRUE;
+}
+
+EGLint __queryBufferAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return 0;
+	}
+
+	// The swap chain of the driver can not be queried.
+
+	return walkerSurface->bufferAge;
+}
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// Without late swap tearing, wait for the vertical blank.
+	if (interval < 0 && !walkerDpy->nativeDisplayContainer.swapControlTear)
+	{
+		interval = -interval;
+	}
+
 	return (EGLBoolean)wglSwapIntervalEXT(interval);
 }
+
+EGLBoolean __hasPresentQueue(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// EGL_DESKTOP_present_queue is not advertised, so a depth greater than zero is rejected with EGL_BAD_MATCH.
+
+	return EGL_FALSE;
+}
+
+EGLnsecsANDROID __getMonotonicTime(void)
+{
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (EGLnsecsANDROID)(counter.QuadPart / frequency.QuadPart) * 1000000000 + (EGLnsecsANDROID)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+}
+
+EGLBoolean __getPresentCounter(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* counter, EGLnsecsANDROID* time)
+{
+	if (!walkerDpy || !walkerSurface || !counter || !time)
+	{
+		return EGL_FALSE;
+	}
+
+	// WGL has no counter of presented frames, so the display present time of the frames is reported as invalid.
+	return EGL_FALSE;
+}
+
+EGLBoolean __createImage(EGLImageImpl* newImage, EGLenum target, EGLClientBuffer buffer, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+	if (!newImage || !walkerDpy || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	// EGL_KHR_image_pixmap is not advertised, as WGL can not bind bitmaps as textures. So no target is supported.
+	*error = EGL_BAD_PARAMETER;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage)
+{
+	if (!walkerDpy || !walkerImage)
+	{
+		return EGL_FALSE;
+	}
+
+	// Nothing to release.
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __bindImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage, GLenum target)
+{
+	if (!walkerDpy || !walkerImage)
+	{
+		return EGL_FALSE;
+	}
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error)
+{
+	if (!walkerDpy || !walkerSurface || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	BITMAP bitmap;
+
+	if (!GetObject((HBITMAP)target, sizeof(BITMAP), &bitmap))
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	// Only the common 32 bit layout is converted.
+	if (bitmap.bmBitsPixel != 32)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	RECT rect;
+
+	if (!GetClientRect(walkerSurface->win, &rect))
+	{
+		*error = EGL_BAD_NATIVE_WINDOW;
+
+		return EGL_FALSE;
+	}
+
+	LONG width = rect.right - rect.left;
+	LONG height = rect.bottom - rect.top;
+
+	if (bitmap.bmWidth < width)
+	{
+		width = bitmap.bmWidth;
+	}
+	if (bitmap.bmHeight < height)
+	{
+		height = bitmap.bmHeight;
+	}
+
+	if (width <= 0 || height <= 0)
+	{
+		return EGL_TRUE;
+	}
+
+	void* pixels = malloc((size_t)width * (size_t)height * 4);
+
+	if (!pixels)
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	GLint packBuffer = 0;
+	GLint packAlignment;
+	GLint packRowLength;
+	GLint readBuffer;
+
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+
+	if (packBuffer)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+	glReadBuffer(walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT);
+
+	glReadPixels(0, 0, (GLsizei)width, (GLsizei)height, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+
+	glReadBuffer((GLenum)readBuffer);
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	if (packBuffer)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)packBuffer);
+	}
+
+	// A bottom up device independent bitmap has the row order of OpenGL, so no conversion is needed.
+	BITMAPINFO bitmapInfo;
+
+	memset(&bitmapInfo, 0, sizeof(BITMAPINFO));
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = width;
+	bitmapInfo.bmiHeader.biHeight = height;
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	EGLBoolean result = EGL_FALSE;
+
+	HDC hdc = CreateCompatibleDC(walkerSurface->nativeSurfaceContainer.hdc);
+
+	if (hdc)
+	{
+		HGDIOBJ previousBitmap = SelectObject(hdc, (HBITMAP)target);
+
+		if (previousBitmap)
+		{
+			result = SetDIBitsToDevice(hdc, 0, 0, (DWORD)width, (DWORD)height, 0, 0, 0, (UINT)height, pixels, &bitmapInfo, DIB_RGB_COLORS) != 0;
+
+			SelectObject(hdc, previousBitmap);
+		}
+
+		DeleteDC(hdc);
+	}
+
+	free(pixels);
+
+	if (!result)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	// The bitmap has to be complete when returning.
+	GdiFlush();
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// Only pbuffers can be bound, which are not supported.
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __createFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint slotCount, size_t slotSize, EGLint* error)
+{
+	if (!walkerDpy || !frameRing || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	// EGL_DESKTOP_frame_ring is not advertised, as consumers are only supported on Linux.
+	*error = EGL_BAD_MATCH;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
+
+	// Rings are never created.
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __waitFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint timeout)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
+
+	// Rings are never created.
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __publishFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
+
+	// Rings are never created.
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __bindLockContext(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
+
+	// The surface is not current to a context of the application while it is locked, so pixels are transferred by a private context.
+	if (!nativeSurfaceContainer->lockCtx)
+	{
+		int pixelFormat = GetPixelFormat(nativeSurfaceContainer->hdc);
+
+		LockContext* lockCtx = walkerDpy->nativeDisplayContainer.rootLockCtx;
+
+		while (lockCtx)
+		{
+			if (lockCtx->pixelFormat == pixelFormat)
+			{
+				break;
+			}
+
+			lockCtx = lockCtx->next;
+		}
+
+		if (!lockCtx)
+		{
+			lockCtx = (LockContext*)malloc(sizeof(LockContext));
+
+			if (!lockCtx)
+			{
+				return EGL_FALSE;
+			}
+
+			lockCtx->pixelFormat = pixelFormat;
+			lockCtx->ctx = wglCreateContext(nativeSurfaceContainer->hdc);
+
+			if (!lockCtx->ctx)
+			{
+				free(lockCtx);
+
+				return EGL_FALSE;
+			}
+
+			lockCtx->next = walkerDpy->nativeDisplayContainer.rootLockCtx;
+			walkerDpy->nativeDisplayContainer.rootLockCtx = lockCtx;
+		}
+
+		nativeSurfaceContainer->lockCtx = lockCtx->ctx;
+	}
+
+	nativeSurfaceContainer->lockPreviousHdc = wglGetCurrentDC();
+	nativeSurfaceContainer->lockPreviousCtx = wglGetCurrentContext();
+
+	return (EGLBoolean)wglMakeCurrent(nativeSurfaceContainer->hdc, nativeSurfaceContainer->lockCtx);
+}
+
+EGLBoolean __unbindLockContext(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
+
+	return (EGLBoolean)wglMakeCurrent(nativeSurfaceContainer->lockPreviousHdc, nativeSurfaceContainer->lockPreviousCtx);
+}
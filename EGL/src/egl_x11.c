@@ -26,538 +26,2684 @@
 
 #include "egl_internal.h"
 
+// Only needed to check, whether the connection can be used by several threads.
+#include <X11/Xlibint.h>
+
+// Not known by older C library headers.
+#if !defined(MFD_CLOEXEC)
+#define MFD_CLOEXEC 0x0001U
+#endif
+
 #if defined(EGL_NO_GLEW)
 typedef GLXContext (*__PFN_glXCreateContextAttribsARB)(Display*, GLXFBConfig,
                                                        GLXContext, Bool,
                                                        const int*);
 typedef void (*__PFN_glXSwapIntervalEXT)(Display*, GLXDrawable, int);
+typedef void (*__PFN_glXBindTexImageEXT)(Display*, GLXDrawable, int, const int*);
+typedef void (*__PFN_glXReleaseTexImageEXT)(Display*, GLXDrawable, int);
 typedef void(*__PFN_glFinish)();
+typedef void (*__PFN_glBindBuffer)(GLenum, GLuint);
+typedef void (*__PFN_glXCopySubBufferMESA)(Display*, GLXDrawable, int, int, int, int);
+typedef Bool (*__PFN_glXGetSyncValuesOML)(Display*, GLXDrawable, int64_t*, int64_t*, int64_t*);
+typedef Bool (*__PFN_glXGetMscRateOML)(Display*, GLXDrawable, int32_t*, int32_t*);
+typedef int64_t (*__PFN_glXSwapBuffersMscOML)(Display*, GLXDrawable, int64_t, int64_t, int64_t);
+typedef GLsync (*__PFN_glFenceSync)(GLenum, GLbitfield);
+typedef void (*__PFN_glWaitSync)(GLsync, GLbitfield, GLuint64);
+typedef GLenum (*__PFN_glClientWaitSync)(GLsync, GLbitfield, GLuint64);
+typedef void (*__PFN_glDeleteSync)(GLsync);
+typedef void (*__PFN_glBlitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+typedef void (*__PFN_glGenBuffers)(GLsizei, GLuint*);
+typedef void (*__PFN_glDeleteBuffers)(GLsizei, const GLuint*);
+typedef void (*__PFN_glBufferData)(GLenum, GLsizeiptr, const void*, GLenum);
+typedef void* (*__PFN_glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+typedef GLboolean (*__PFN_glUnmapBuffer)(GLenum);
+typedef void (*__PFN_glBindFramebuffer)(GLenum, GLuint);
+typedef GLuint (*__PFN_glCreateShader)(GLenum);
+typedef void (*__PFN_glShaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+typedef void (*__PFN_glCompileShader)(GLuint);
+typedef void (*__PFN_glGetShaderiv)(GLuint, GLenum, GLint*);
+typedef void (*__PFN_glDeleteShader)(GLuint);
+typedef GLuint (*__PFN_glCreateProgram)(void);
+typedef void (*__PFN_glAttachShader)(GLuint, GLuint);
+typedef void (*__PFN_glLinkProgram)(GLuint);
+typedef void (*__PFN_glGetProgramiv)(GLuint, GLenum, GLint*);
+typedef void (*__PFN_glDeleteProgram)(GLuint);
+typedef void (*__PFN_glUseProgram)(GLuint);
+typedef GLint (*__PFN_glGetUniformLocation)(GLuint, const GLchar*);
+typedef void (*__PFN_glUniform1i)(GLint, GLint);
+typedef void (*__PFN_glUniform2i)(GLint, GLint, GLint);
+typedef void (*__PFN_glActiveTexture)(GLenum);
+typedef void (*__PFN_glGenFramebuffers)(GLsizei, GLuint*);
+typedef void (*__PFN_glDeleteFramebuffers)(GLsizei, const GLuint*);
+typedef void (*__PFN_glFramebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+typedef void (*__PFN_glGenVertexArrays)(GLsizei, GLuint*);
+typedef void (*__PFN_glBindVertexArray)(GLuint);
+typedef void (*__PFN_glDeleteVertexArrays)(GLsizei, const GLuint*);
+typedef void (*__PFN_glBindSampler)(GLuint, GLuint);
+typedef const GLubyte* (*__PFN_glGetStringi)(GLenum, GLuint);
+typedef void (*__PFN_glBufferStorage)(GLenum, GLsizeiptr, const void*, GLbitfield);
 
 __PFN_glXCreateContextAttribsARB glXCreateContextAttribsARB_PTR = NULL;
 __PFN_glXSwapIntervalEXT glXSwapIntervalEXT_PTR = NULL;
+__PFN_glXBindTexImageEXT glXBindTexImageEXT_PTR = NULL;
+__PFN_glXReleaseTexImageEXT glXReleaseTexImageEXT_PTR = NULL;
 __PFN_glFinish glFinish_PTR = NULL;
+__PFN_glBindBuffer glBindBuffer_PTR = NULL;
+__PFN_glXCopySubBufferMESA glXCopySubBufferMESA_PTR = NULL;
+__PFN_glXGetSyncValuesOML glXGetSyncValuesOML_PTR = NULL;
+__PFN_glXGetMscRateOML glXGetMscRateOML_PTR = NULL;
+__PFN_glXSwapBuffersMscOML glXSwapBuffersMscOML_PTR = NULL;
+__PFN_glFenceSync glFenceSync_PTR = NULL;
+__PFN_glWaitSync glWaitSync_PTR = NULL;
+__PFN_glClientWaitSync glClientWaitSync_PTR = NULL;
+__PFN_glDeleteSync glDeleteSync_PTR = NULL;
+__PFN_glBlitFramebuffer glBlitFramebuffer_PTR = NULL;
+__PFN_glGenBuffers glGenBuffers_PTR = NULL;
+__PFN_glDeleteBuffers glDeleteBuffers_PTR = NULL;
+__PFN_glBufferData glBufferData_PTR = NULL;
+__PFN_glMapBufferRange glMapBufferRange_PTR = NULL;
+__PFN_glUnmapBuffer glUnmapBuffer_PTR = NULL;
+__PFN_glBindFramebuffer glBindFramebuffer_PTR = NULL;
+__PFN_glCreateShader glCreateShader_PTR = NULL;
+__PFN_glShaderSource glShaderSource_PTR = NULL;
+__PFN_glCompileShader glCompileShader_PTR = NULL;
+__PFN_glGetShaderiv glGetShaderiv_PTR = NULL;
+__PFN_glDeleteShader glDeleteShader_PTR = NULL;
+__PFN_glCreateProgram glCreateProgram_PTR = NULL;
+__PFN_glAttachShader glAttachShader_PTR = NULL;
+__PFN_glLinkProgram glLinkProgram_PTR = NULL;
+__PFN_glGetProgramiv glGetProgramiv_PTR = NULL;
+__PFN_glDeleteProgram glDeleteProgram_PTR = NULL;
+__PFN_glUseProgram glUseProgram_PTR = NULL;
+__PFN_glGetUniformLocation glGetUniformLocation_PTR = NULL;
+__PFN_glUniform1i glUniform1i_PTR = NULL;
+__PFN_glUniform2i glUniform2i_PTR = NULL;
+__PFN_glActiveTexture glActiveTexture_PTR = NULL;
+__PFN_glGenFramebuffers glGenFramebuffers_PTR = NULL;
+__PFN_glDeleteFramebuffers glDeleteFramebuffers_PTR = NULL;
+__PFN_glFramebufferTexture2D glFramebufferTexture2D_PTR = NULL;
+__PFN_glGenVertexArrays glGenVertexArrays_PTR = NULL;
+__PFN_glBindVertexArray glBindVertexArray_PTR = NULL;
+__PFN_glDeleteVertexArrays glDeleteVertexArrays_PTR = NULL;
+__PFN_glBindSampler glBindSampler_PTR = NULL;
+__PFN_glGetStringi glGetStringi_PTR = NULL;
+__PFN_glBufferStorage glBufferStorage_PTR = NULL;
 
 #define glXSwapIntervalEXT(...) glXSwapIntervalEXT_PTR(__VA_ARGS__)
 #define glXCreateContextAttribsARB(...) \
     glXCreateContextAttribsARB_PTR(__VA_ARGS__)
+#define glXBindTexImageEXT(...) glXBindTexImageEXT_PTR(__VA_ARGS__)
+#define glXReleaseTexImageEXT(...) glXReleaseTexImageEXT_PTR(__VA_ARGS__)
+#define glBindBuffer(...) glBindBuffer_PTR(__VA_ARGS__)
+#define glXCopySubBufferMESA(...) glXCopySubBufferMESA_PTR(__VA_ARGS__)
+#define glXGetSyncValuesOML(...) glXGetSyncValuesOML_PTR(__VA_ARGS__)
+#define glXGetMscRateOML(...) glXGetMscRateOML_PTR(__VA_ARGS__)
+#define glXSwapBuffersMscOML(...) glXSwapBuffersMscOML_PTR(__VA_ARGS__)
+#define glFenceSync(...) glFenceSync_PTR(__VA_ARGS__)
+#define glWaitSync(...) glWaitSync_PTR(__VA_ARGS__)
+#define glClientWaitSync(...) glClientWaitSync_PTR(__VA_ARGS__)
+#define glDeleteSync(...) glDeleteSync_PTR(__VA_ARGS__)
+#define glBlitFramebuffer(...) glBlitFramebuffer_PTR(__VA_ARGS__)
+#define glGenBuffers(...) glGenBuffers_PTR(__VA_ARGS__)
+#define glDeleteBuffers(...) glDeleteBuffers_PTR(__VA_ARGS__)
+#define glBufferData(...) glBufferData_PTR(__VA_ARGS__)
+#define glMapBufferRange(...) glMapBufferRange_PTR(__VA_ARGS__)
+#define glUnmapBuffer(...) glUnmapBuffer_PTR(__VA_ARGS__)
 #endif 
 
-__eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname)
-{
-	return (__eglMustCastToProperFunctionPointerType )glXGetProcAddress((const GLubyte *)procname);
-}
-
-EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContainer)
+static EGLBoolean __hasExtension(const char* extensions, const char* extension)
 {
-	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->window && nativeLocalStorageContainer->ctx)
-	{
-		return EGL_TRUE;
-	}
-
-	if (nativeLocalStorageContainer->display)
+	if (!extensions || !extension)
 	{
 		return EGL_FALSE;
 	}
 
-	if (nativeLocalStorageContainer->window)
+	size_t length = strlen(extension);
+
+	const char* walkerExtension = extensions;
+
+	while ((walkerExtension = strstr(walkerExtension, extension)) != 0)
 	{
-		return EGL_FALSE;
+		// Only accept complete names, as some extensions are prefixes of others.
+		if ((walkerExtension == extensions || walkerExtension[-1] == ' ') && (walkerExtension[length] == ' ' || walkerExtension[length] == '\0'))
+		{
+			return EGL_TRUE;
+		}
+
+		walkerExtension += length;
 	}
 
-	if (nativeLocalStorageContainer->ctx)
+	return EGL_FALSE;
+}
+
+static GLXFBConfig __getFBConfig(const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig)
+{
+	EGLint numberPixelFormats;
+
+	GLXFBConfig* fbConfigs = glXGetFBConfigs(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), &numberPixelFormats);
+
+	if (!fbConfigs || numberPixelFormats == 0)
 	{
-		return EGL_FALSE;
+		if (fbConfigs)
+		{
+			XFree(fbConfigs);
+		}
+
+		return 0;
 	}
 
-	nativeLocalStorageContainer->display = XOpenDisplay(NULL);
+	GLXFBConfig config = 0;
 
-	if (!nativeLocalStorageContainer->display)
+	// The configuration identifier is the index, as gathered during initialization.
+	if (walkerConfig->configId >= 0 && walkerConfig->configId < numberPixelFormats)
 	{
-		return EGL_FALSE;
+		config = fbConfigs[walkerConfig->configId];
 	}
 
-	//
+	XFree(fbConfigs);
 
-	int glxMajor;
-	int glxMinor;
+	return config;
+}
 
-	// GLX version 1.4 or higher needed.
-	if (!glXQueryVersion(nativeLocalStorageContainer->display, &glxMajor, &glxMinor))
-	{
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+__eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname)
+{
+	return (__eglMustCastToProperFunctionPointerType )glXGetProcAddress((const GLubyte *)procname);
+}
 
-		return EGL_FALSE;
-	}
+// Errors of the requests, which are trapped by the calling thread.
+typedef struct _ErrorTrap {
 
-	if (glxMajor < 1 || (glxMajor == 1 && glxMinor < 4))
-	{
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+	Display* display;
 
-		return EGL_FALSE;
-	}
+	unsigned long serial;
 
-	//
+	XErrorHandler previousHandler;
 
-	nativeLocalStorageContainer->window = DefaultRootWindow(nativeLocalStorageContainer->display);
+	int errorCode;
 
-	if (!nativeLocalStorageContainer->window)
-	{
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+} ErrorTrap;
 
-		return EGL_FALSE;
-	}
+static __thread ErrorTrap* g_errorTrap = 0;
 
-	int dummyAttribList[] = {
-		GLX_USE_GL, True,
-		GLX_DOUBLEBUFFER, True,
-		GLX_RGBA, True,
-		None
-	};
+// Handler of the application or of Xlib, which was installed before the first trap.
+static XErrorHandler g_previousErrorHandler = 0;
 
-	XVisualInfo* visualInfo = glXChooseVisual(nativeLocalStorageContainer->display, 0, dummyAttribList);
+static int __errorHandler(Display* display, XErrorEvent* event)
+{
+	// Errors are reported on the thread, which reads them from the connection.
+	ErrorTrap* errorTrap = g_errorTrap;
 
-	if (!visualInfo)
+	if (errorTrap && errorTrap->display == display && event->serial >= errorTrap->serial)
 	{
-		nativeLocalStorageContainer->window = 0;
-
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+		if (!errorTrap->errorCode)
+		{
+			errorTrap->errorCode = event->error_code;
+		}
 
-		return EGL_FALSE;
+		return 0;
 	}
-  
-	nativeLocalStorageContainer->ctx = glXCreateContext(nativeLocalStorageContainer->display, visualInfo, NULL, True);
 
-	if (!nativeLocalStorageContainer->ctx)
+	// Errors of other threads, other connections or earlier requests are not ours to decide about.
+	if (g_previousErrorHandler)
 	{
-		nativeLocalStorageContainer->window = 0;
-
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
-
-		return EGL_FALSE;
+		return g_previousErrorHandler(display, event);
 	}
 
-	if (!glXMakeCurrent(nativeLocalStorageContainer->display, nativeLocalStorageContainer->window, nativeLocalStorageContainer->ctx))
-	{
-		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
-		nativeLocalStorageContainer->ctx = 0;
+	return 0;
+}
 
-		nativeLocalStorageContainer->window = 0;
+static void __beginErrorTrap(Display* display, ErrorTrap* errorTrap)
+{
+	errorTrap->display = display;
+	errorTrap->serial = NextRequest(display);
+	errorTrap->errorCode = 0;
 
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+	errorTrap->previousHandler = XSetErrorHandler(__errorHandler);
 
-		return EGL_FALSE;
+	// While another thread has a trap, our own handler is already installed.
+	if (errorTrap->previousHandler != __errorHandler)
+	{
+		g_previousErrorHandler = errorTrap->previousHandler;
 	}
 
-#if !defined(EGL_NO_GLEW)
-	glewExperimental = GL_TRUE;
-	if (glewInit() != GL_NO_ERROR)
-	{
-		glXMakeCurrent(nativeLocalStorageContainer->display, 0, 0);
+	g_errorTrap = errorTrap;
+}
 
-		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
-		nativeLocalStorageContainer->ctx = 0;
+static int __endErrorTrap(ErrorTrap* errorTrap)
+{
+	// All trapped requests have to be processed by the server.
+	XSync(errorTrap->display, False);
 
-		nativeLocalStorageContainer->window = 0;
+	g_errorTrap = 0;
 
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+	XSetErrorHandler(errorTrap->previousHandler);
 
-		return EGL_FALSE;
-	}
+	return errorTrap->errorCode;
+}
+
+static EGLBoolean __hasPixelBuffers()
+{
+#if defined(EGL_NO_GLEW)
+	return glFenceSync_PTR && glClientWaitSync_PTR && glDeleteSync_PTR && glGenBuffers_PTR && glBindBuffer_PTR && glBufferData_PTR && glMapBufferRange_PTR && glUnmapBuffer_PTR;
 #else
-  glXCreateContextAttribsARB_PTR =
-    (__PFN_glXCreateContextAttribsARB)
-        __getProcAddress("glXCreateContextAttribsARB");
-  glXSwapIntervalEXT_PTR =
-    (__PFN_glXSwapIntervalEXT)__getProcAddress("glXSwapIntervalEXT");
-  glFinish_PTR = (__PFN_glFinish)__getProcAddress("glFinish");
+	return glFenceSync && glClientWaitSync && glDeleteSync && glGenBuffers && glBindBuffer && glBufferData && glMapBufferRange && glUnmapBuffer;
 #endif
-	return EGL_TRUE;
 }
 
-EGLBoolean __internalTerminate(NativeLocalStorageContainer* nativeLocalStorageContainer)
+static void __destroyStagingImage(const EGLDisplayImpl* walkerDpy, NativeSurfaceContainer* nativeSurfaceContainer)
 {
-	if (!nativeLocalStorageContainer)
-	{
-		return EGL_FALSE;
-	}
+	XImage* image = nativeSurfaceContainer->image;
 
-	if (nativeLocalStorageContainer->display)
+	if (!image)
 	{
-		glXMakeContextCurrent(nativeLocalStorageContainer->display, 0, 0, 0);
+		return;
 	}
 
-	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->ctx)
+	if (nativeSurfaceContainer->shmInfo.shmaddr)
 	{
-		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
-		nativeLocalStorageContainer->ctx = 0;
-	}
+		XShmDetach(walkerDpy->display_id, &nativeSurfaceContainer->shmInfo);
+		XSync(walkerDpy->display_id, False);
 
-	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->window)
-	{
-		XDestroyWindow(nativeLocalStorageContainer->display, nativeLocalStorageContainer->window);
-		nativeLocalStorageContainer->window = 0;
-	}
+		shmdt(nativeSurfaceContainer->shmInfo.shmaddr);
 
-	if (nativeLocalStorageContainer->display)
-	{
-		XCloseDisplay(nativeLocalStorageContainer->display);
-		nativeLocalStorageContainer->display = 0;
+		nativeSurfaceContainer->shmInfo.shmaddr = 0;
+
+		// The data is not owned by the image.
+		image->data = 0;
 	}
 
-	return EGL_TRUE;
+	XDestroyImage(image);
+
+	nativeSurfaceContainer->image = 0;
 }
 
-EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextContainer* nativeContextContainer)
+static XImage* __createStagingImage(const EGLDisplayImpl* walkerDpy, NativeSurfaceContainer* nativeSurfaceContainer, unsigned int depth, unsigned int width, unsigned int height)
 {
-	if (!walkerDpy || !nativeContextContainer)
+	XImage* image = nativeSurfaceContainer->image;
+
+	// Reuse the image of the last copy, if it still matches.
+	if (image && (unsigned int)image->depth == depth && (unsigned int)image->width == width && (unsigned int)image->height == height)
 	{
-		return EGL_FALSE;
+		return image;
 	}
 
-	glXDestroyContext(walkerDpy->display_id, nativeContextContainer->ctx);
+	__destroyStagingImage(walkerDpy, nativeSurfaceContainer);
 
-	return EGL_TRUE;
-}
+	XVisualInfo visualInfo;
 
-EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, EGLint* error)
-{
-	if (!target_attrib_list || !attrib_list || !error)
+	if (!XMatchVisualInfo(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), (int)depth, TrueColor, &visualInfo))
 	{
-		return EGL_FALSE;
+		return 0;
 	}
 
-	EGLint template_attrib_list[] = {
-			GLX_CONTEXT_MAJOR_VERSION_ARB, 1,
-			GLX_CONTEXT_MINOR_VERSION_ARB, 0,
-			GLX_CONTEXT_FLAGS_ARB, 0,
-			GLX_CONTEXT_PROFILE_MASK_ARB, 0,
-			GLX_CONTEXT_RESET_NOTIFICATION_STRATEGY_ARB, GLX_NO_RESET_NOTIFICATION_ARB,
-			0
-	};
-
-	EGLint attribListIndex = 0;
-
-	while (attrib_list[attribListIndex] != EGL_NONE)
+	// Shared memory avoids sending the pixels through the X protocol.
+	if (walkerDpy->nativeDisplayContainer.sharedMemory)
 	{
-		EGLint value = attrib_list[attribListIndex + 1];
+		image = XShmCreateImage(walkerDpy->display_id, visualInfo.visual, depth, ZPixmap, 0, &nativeSurfaceContainer->shmInfo, width, height);
 
-		switch (attrib_list[attribListIndex])
+		if (image)
 		{
-			case EGL_CONTEXT_MAJOR_VERSION:
+			nativeSurfaceContainer->shmInfo.shmid = shmget(IPC_PRIVATE, (size_t)(image->bytes_per_line * image->height), IPC_CREAT | 0600);
+
+			if (nativeSurfaceContainer->shmInfo.shmid >= 0)
 			{
-				if (value < 1)
-				{
-					*error = EGL_BAD_ATTRIBUTE;
+				nativeSurfaceContainer->shmInfo.shmaddr = (char*)shmat(nativeSurfaceContainer->shmInfo.shmid, 0, 0);
 
-					return EGL_FALSE;
+				if (nativeSurfaceContainer->shmInfo.shmaddr == (char*)-1)
+				{
+					nativeSurfaceContainer->shmInfo.shmaddr = 0;
 				}
-
-				template_attrib_list[1] = value;
 			}
-			break;
-			case EGL_CONTEXT_MINOR_VERSION:
+
+			if (nativeSurfaceContainer->shmInfo.shmaddr)
 			{
-				if (value < 0)
-				{
-					*error = EGL_BAD_ATTRIBUTE;
+				nativeSurfaceContainer->shmInfo.readOnly = False;
 
-					return EGL_FALSE;
-				}
+				// Attaching fails e.g. for remote servers, which is only reported asynchronously.
+				ErrorTrap errorTrap;
 
-				template_attrib_list[3] = value;
-			}
-			break;
-			case EGL_CONTEXT_OPENGL_PROFILE_MASK:
-			{
-				if (value == EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT)
-				{
-					template_attrib_list[7] = GLX_CONTEXT_CORE_PROFILE_BIT_ARB;
-				}
-				else if (value == EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT)
-				{
-					template_attrib_list[7] = GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB;
-				}
-				else
+				__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+				XShmAttach(walkerDpy->display_id, &nativeSurfaceContainer->shmInfo);
+
+				if (__endErrorTrap(&errorTrap))
 				{
-					*error = EGL_BAD_ATTRIBUTE;
+					shmdt(nativeSurfaceContainer->shmInfo.shmaddr);
 
-					return EGL_FALSE;
+					nativeSurfaceContainer->shmInfo.shmaddr = 0;
 				}
 			}
-			break;
-			case EGL_CONTEXT_OPENGL_DEBUG:
-			{
-				if (value == EGL_TRUE)
-				{
-					template_attrib_list[5] |= GLX_CONTEXT_DEBUG_BIT_ARB;
-				}
-				else if (value == EGL_FALSE)
-				{
-					template_attrib_list[5] &= ~GLX_CONTEXT_DEBUG_BIT_ARB;
-				}
-				else
-				{
-					*error = EGL_BAD_ATTRIBUTE;
 
-					return EGL_FALSE;
-				}
+			if (nativeSurfaceContainer->shmInfo.shmid >= 0)
+			{
+				// Segment is released, as soon as both sides have detached.
+				shmctl(nativeSurfaceContainer->shmInfo.shmid, IPC_RMID, 0);
 			}
-			break;
-			case EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE:
+
+			if (nativeSurfaceContainer->shmInfo.shmaddr)
 			{
-				if (value == EGL_TRUE)
-				{
-					template_attrib_list[5] |= GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
-				}
-				else if (value == EGL_FALSE)
-				{
-					template_attrib_list[5] &= ~GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
-				}
-				else
-				{
-					*error = EGL_BAD_ATTRIBUTE;
+				image->data = nativeSurfaceContainer->shmInfo.shmaddr;
 
-					return EGL_FALSE;
-				}
+				nativeSurfaceContainer->image = image;
+
+				return image;
 			}
-			break;
-			case EGL_CONTEXT_OPENGL_ROBUST_ACCESS:
-			{
-				if (value == EGL_TRUE)
-				{
-					template_attrib_list[5] |= GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
-				}
-				else if (value == EGL_FALSE)
-				{
-					template_attrib_list[5] &= ~GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
-				}
-				else
-				{
-					*error = EGL_BAD_ATTRIBUTE;
 
-					return EGL_FALSE;
-				}
-			}
-			break;
-			case EGL_CONTEXT_OPENGL_RESET_NOTIFICATION_STRATEGY:
-			{
-				if (value == EGL_NO_RESET_NOTIFICATION)
-				{
-					template_attrib_list[9] = GLX_NO_RESET_NOTIFICATION_ARB;
-				}
-				else if (value == EGL_LOSE_CONTEXT_ON_RESET)
-				{
-					template_attrib_list[9] = GLX_LOSE_CONTEXT_ON_RESET_ARB;
-				}
-				else
-				{
-					*error = EGL_BAD_ATTRIBUTE;
+			XDestroyImage(image);
+		}
+	}
 
-					return EGL_FALSE;
-				}
-			}
-			break;
-			default:
-			{
-				*error = EGL_BAD_ATTRIBUTE;
+	// Fall back to a client side image.
 
-				return EGL_FALSE;
-			}
-			break;
-		}
+	image = XCreateImage(walkerDpy->display_id, visualInfo.visual, depth, ZPixmap, 0, 0, width, height, 32, 0);
 
-		attribListIndex += 2;
+	if (!image)
+	{
+		return 0;
+	}
 
-		// More than 14 entries can not exist.
-		if (attribListIndex >= 7 * 2)
-		{
-			*error = EGL_BAD_ATTRIBUTE;
+	image->data = (char*)malloc((size_t)(image->bytes_per_line * image->height));
 
-			return EGL_FALSE;
-		}
+	if (!image->data)
+	{
+		XDestroyImage(image);
+
+		return 0;
 	}
 
-	memcpy(target_attrib_list, template_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+	nativeSurfaceContainer->image = image;
 
-	return EGL_TRUE;
+	return image;
 }
 
-EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType win, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+EGLnsecsANDROID __getMonotonicTime(void)
 {
-	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (EGLnsecsANDROID)now.tv_sec * 1000000000 + (EGLnsecsANDROID)now.tv_nsec;
+}
+
+static void __sleepUntil(EGLnsecsANDROID time)
+{
+	struct timespec wake;
+
+	wake.tv_sec = (time_t)(time / 1000000000);
+	wake.tv_nsec = (long)(time % 1000000000);
+
+	// The absolute time is not shortened by interruptions, and the time may already be over.
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, 0) == EINTR)
 	{
-		return EGL_FALSE;
+		// Interrupted by a signal.
 	}
+}
 
-	if (attrib_list)
+// Returns the first media stream counter, which is displayed not before the given time. Zero, if it is not known.
+static int64_t __getTargetMsc(Display* display, GLXDrawable drawable, EGLnsecsANDROID time)
+{
+	int64_t ust;
+	int64_t msc;
+	int64_t sbc;
+
+	int32_t numerator;
+	int32_t denominator;
+
+	if (!glXGetSyncValuesOML(display, drawable, &ust, &msc, &sbc) || !glXGetMscRateOML(display, drawable, &numerator, &denominator) || numerator <= 0 || denominator <= 0)
 	{
-		EGLint indexAttribList = 0;
+		return 0;
+	}
 
-		while (attrib_list[indexAttribList] != EGL_NONE)
+	// The system time is given in microseconds of the monotonic clock.
+	int64_t delta = time / 1000 - ust;
+
+	if (delta <= 0)
+	{
+		return msc + 1;
+	}
+
+	// A frame lasts denominator / numerator seconds.
+	int64_t frames = (delta * numerator + (int64_t)denominator * 1000000 - 1) / ((int64_t)denominator * 1000000);
+
+	return msc + frames;
+}
+
+static void __presentWindow(Display* display, GLXDrawable drawable, Bool syncControl, EGLnsecsANDROID time)
+{
+	if (time > 0)
+	{
+		if (syncControl)
 		{
-			EGLint value = attrib_list[indexAttribList + 1];
+			int64_t targetMsc = __getTargetMsc(display, drawable, time);
 
-			switch (attrib_list[indexAttribList])
+			if (targetMsc > 0)
 			{
-				case EGL_GL_COLORSPACE:
-				{
-					if (value == EGL_GL_COLORSPACE_LINEAR)
-					{
-						// Do nothing.
-					}
-					else if (value == EGL_GL_COLORSPACE_SRGB)
-					{
-						*error = EGL_BAD_MATCH;
+				glXSwapBuffersMscOML(display, drawable, targetMsc, 0, 0);
 
-						return EGL_FALSE;
-					}
-					else
-					{
-						*error = EGL_BAD_ATTRIBUTE;
+				return;
+			}
+		}
 
-						return EGL_FALSE;
-					}
-				}
-				break;
-				case EGL_RENDER_BUFFER:
-				{
-					if (value == EGL_SINGLE_BUFFER)
-					{
-						if (walkerConfig->doubleBuffer)
-						{
-							*error = EGL_BAD_MATCH;
+		// Swap is done at the first vertical blank after the time.
+		__sleepUntil(time);
+	}
 
-							return EGL_FALSE;
-						}
-					}
-					else if (value == EGL_BACK_BUFFER)
-					{
-						if (!walkerConfig->doubleBuffer)
-						{
-							*error = EGL_BAD_MATCH;
+	glXSwapBuffers(display, drawable);
+}
 
-							return EGL_FALSE;
-						}
-					}
-					else
-					{
-						*error = EGL_BAD_ATTRIBUTE;
+// Marks the end of the queue for the present thread.
+#define PRESENT_QUEUE_QUIT -1
 
-						return EGL_FALSE;
-					}
-				}
-				break;
-				case EGL_VG_ALPHA_FORMAT:
-				{
-					*error = EGL_BAD_MATCH;
+// Single producer and single consumer ring without locks. Each index is only written by one thread.
+// The semaphore counts the entries and only puts the consumer to sleep, if the ring is empty.
+typedef struct _PresentRing {
 
-					return EGL_FALSE;
-				}
-				break;
-				case EGL_VG_COLORSPACE:
-				{
-					*error = EGL_BAD_MATCH;
+	EGLint entries[MAX_PRESENT_QUEUE_DEPTH + 2];
 
-					return EGL_FALSE;
-				}
-				break;
-			}
+	EGLint head;
+	EGLint tail;
 
-			indexAttribList += 2;
+	sem_t count;
 
-			// More than 4 entries can not exist.
-			if (indexAttribList >= 4 * 2)
-			{
-				*error = EGL_BAD_ATTRIBUTE;
+} PresentRing;
 
-				return EGL_FALSE;
-			}
+// A context can only be bound to drawables of a compatible configuration, so the locked surfaces of a display share one per configuration.
+typedef struct _LockContext {
+
+	GLXFBConfig config;
+
+	GLXContext ctx;
+
+	struct _LockContext* next;
+
+} LockContext;
+
+typedef struct _PresentQueue {
+
+	// Drawables and direct contexts can not be shared across connections, so the present thread uses the one of the application.
+	Display* display;
+
+	GLXDrawable window;
+
+	Bool syncControl;
+
+	Bool swapControl;
+
+	// Set by the rendering thread and applied by the present thread, which owns the window.
+	EGLint swapInterval;
+
+	// Context of the present thread. Shares the fences with the rendering context.
+	GLXContext ctx;
+
+	GLXContext sharedCtx;
+
+	EGLint depth;
+
+	EGLint width;
+	EGLint height;
+
+	// Rendering is redirected into these, as the present thread owns the window.
+	GLXPbuffer buffers[MAX_PRESENT_QUEUE_DEPTH + 1];
+
+	// Signaled, when a frame is rendered respectively presented.
+	GLsync renderFences[MAX_PRESENT_QUEUE_DEPTH + 1];
+	GLsync releaseFences[MAX_PRESENT_QUEUE_DEPTH + 1];
+
+	EGLnsecsANDROID presentationTimes[MAX_PRESENT_QUEUE_DEPTH + 1];
+
+	EGLint renderIndex;
+
+	// Frames to present respectively buffers to render to.
+	PresentRing queued;
+	PresentRing released;
+
+	pthread_t thread;
+
+} PresentQueue;
+
+static void __waitSemaphore(sem_t* semaphore)
+{
+	while (sem_wait(semaphore) != 0)
+	{
+		// Interrupted by a signal.
+	}
+}
+
+static void __pushPresentRing(PresentRing* presentRing, EGLint entry)
+{
+	EGLint tail = presentRing->tail;
+
+	presentRing->entries[tail] = entry;
+
+	__atomic_store_n(&presentRing->tail, (tail + 1) % (MAX_PRESENT_QUEUE_DEPTH + 2), __ATOMIC_RELEASE);
+
+	sem_post(&presentRing->count);
+}
+
+static EGLint __popPresentRing(PresentRing* presentRing)
+{
+	// Without waiters, waiting respectively posting is one atomic operation and does not enter the kernel.
+	__waitSemaphore(&presentRing->count);
+
+	EGLint head = presentRing->head;
+
+	// The entry is counted after it is published, so it is visible now.
+	EGLint entry = presentRing->entries[head];
+
+	presentRing->head = (head + 1) % (MAX_PRESENT_QUEUE_DEPTH + 2);
+
+	return entry;
+}
+
+static void* __presentThread(void* argument)
+{
+	PresentQueue* presentQueue = (PresentQueue*)argument;
+
+	Bool swapIntervalApplied = False;
+	EGLint appliedSwapInterval = 0;
+
+	while (1)
+	{
+		EGLint index = __popPresentRing(&presentQueue->queued);
+
+		if (index == PRESENT_QUEUE_QUIT)
+		{
+			break;
+		}
+
+		glXMakeContextCurrent(presentQueue->display, presentQueue->window, presentQueue->buffers[index], presentQueue->ctx);
+
+		EGLint swapInterval = __atomic_load_n(&presentQueue->swapInterval, __ATOMIC_RELAXED);
+
+		if (presentQueue->swapControl && (!swapIntervalApplied || swapInterval != appliedSwapInterval))
+		{
+			glXSwapIntervalEXT(presentQueue->display, presentQueue->window, swapInterval);
+
+			swapIntervalApplied = True;
+			appliedSwapInterval = swapInterval;
 		}
+
+		// The GPU waits for the frame, not this thread.
+		glWaitSync(presentQueue->renderFences[index], 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(presentQueue->renderFences[index]);
+		presentQueue->renderFences[index] = 0;
+
+		glBlitFramebuffer(0, 0, presentQueue->width, presentQueue->height, 0, 0, presentQueue->width, presentQueue->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		presentQueue->releaseFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		// The buffer is not kept bound, as the rendering thread acquires it again.
+		glXMakeContextCurrent(presentQueue->display, presentQueue->window, presentQueue->window, presentQueue->ctx);
+
+		// Blocks, if vertical synchronization is enabled and enough frames are pending.
+		__presentWindow(presentQueue->display, presentQueue->window, presentQueue->syncControl, presentQueue->presentationTimes[index]);
+
+		__pushPresentRing(&presentQueue->released, index);
 	}
 
-	//
+	// Buffers, which are not acquired again, still have a fence.
+	EGLint i;
 
-	EGLint numberPixelFormats;
+	for (i = 0; i <= presentQueue->depth; i++)
+	{
+		if (presentQueue->releaseFences[i])
+		{
+			glDeleteSync(presentQueue->releaseFences[i]);
+			presentQueue->releaseFences[i] = 0;
+		}
+	}
 
-	GLXFBConfig* fbConfigs = glXGetFBConfigs(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), &numberPixelFormats);
+	glXMakeContextCurrent(presentQueue->display, None, None, 0);
 
-	if (!fbConfigs || numberPixelFormats == 0)
+	return 0;
+}
+
+static void __destroyPresentQueue(NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	PresentQueue* presentQueue = nativeSurfaceContainer->presentQueue;
+
+	if (!presentQueue)
 	{
-		if (fbConfigs)
+		return;
+	}
+
+	// All queued frames are presented before.
+	__pushPresentRing(&presentQueue->queued, PRESENT_QUEUE_QUIT);
+
+	pthread_join(presentQueue->thread, 0);
+
+	GLXDrawable currentDrawable = glXGetCurrentDrawable();
+
+	EGLint i;
+
+	for (i = 0; i <= presentQueue->depth; i++)
+	{
+		// Rendering continues on the window.
+		if (currentDrawable && currentDrawable == presentQueue->buffers[i])
 		{
-			XFree(fbConfigs);
+			glXMakeContextCurrent(presentQueue->display, presentQueue->window, presentQueue->window, glXGetCurrentContext());
 		}
 
+		glXDestroyPbuffer(presentQueue->display, presentQueue->buffers[i]);
+	}
+
+	glXDestroyContext(presentQueue->display, presentQueue->ctx);
+
+	sem_destroy(&presentQueue->queued.count);
+	sem_destroy(&presentQueue->released.count);
+
+	free(presentQueue);
+
+	nativeSurfaceContainer->presentQueue = 0;
+}
+
+static EGLint __getNativeSwapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+{
+	// Without late swap tearing, wait for the vertical blank.
+	if (interval < 0 && !walkerDpy->nativeDisplayContainer.swapControlTear)
+	{
+		return -interval;
+	}
+
+	return interval;
+}
+
+static EGLBoolean __createPresentQueue(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
+
+	// Without XInitThreads before opening the connection, frames are presented by the rendering thread.
+	if (!walkerDpy->display_id->lock_fns)
+	{
 		return EGL_FALSE;
 	}
 
-	EGLint attribute;
+	PresentQueue* presentQueue = (PresentQueue*)malloc(sizeof(PresentQueue));
 
-	XVisualInfo* visualInfo;
+	if (!presentQueue)
+	{
+		return EGL_FALSE;
+	}
 
-	GLXFBConfig config = 0;
+	memset(presentQueue, 0, sizeof(PresentQueue));
+
+	presentQueue->display = walkerDpy->display_id;
+	presentQueue->window = nativeSurfaceContainer->drawable;
+	presentQueue->syncControl = walkerDpy->nativeDisplayContainer.syncControl;
+	presentQueue->swapControl = walkerDpy->nativeDisplayContainer.swapControl;
+	presentQueue->swapInterval = __getNativeSwapInterval(walkerDpy, walkerSurface->swapInterval);
+	presentQueue->sharedCtx = glXGetCurrentContext();
+	presentQueue->depth = walkerSurface->presentQueueDepth;
+	// Pbuffers can not be empty.
+	presentQueue->width = walkerSurface->width > 0 ? walkerSurface->width : 1;
+	presentQueue->height = walkerSurface->height > 0 ? walkerSurface->height : 1;
+
+	int pbufferAttribList[] = {
+		GLX_PBUFFER_WIDTH, presentQueue->width,
+		GLX_PBUFFER_HEIGHT, presentQueue->height,
+		GLX_PRESERVED_CONTENTS, True,
+		None
+	};
 
-	for (EGLint currentPixelFormat = 0; currentPixelFormat < numberPixelFormats; currentPixelFormat++)
+	EGLint i;
+
+	for (i = 0; i <= presentQueue->depth; i++)
 	{
-		EGLint value;
+		presentQueue->buffers[i] = glXCreatePbuffer(presentQueue->display, nativeSurfaceContainer->config, pbufferAttribList);
 
-		attribute = GLX_VISUAL_ID;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
+		if (!presentQueue->buffers[i])
 		{
-			XFree(fbConfigs);
+			while (i > 0)
+			{
+				i--;
+
+				glXDestroyPbuffer(presentQueue->display, presentQueue->buffers[i]);
+			}
+
+			free(presentQueue);
 
 			return EGL_FALSE;
 		}
-		if (!value)
+	}
+
+	presentQueue->ctx = glXCreateNewContext(presentQueue->display, nativeSurfaceContainer->config, GLX_RGBA_TYPE, presentQueue->sharedCtx, True);
+
+	if (!presentQueue->ctx)
+	{
+		for (i = 0; i <= presentQueue->depth; i++)
+		{
+			glXDestroyPbuffer(presentQueue->display, presentQueue->buffers[i]);
+		}
+
+		free(presentQueue);
+
+		return EGL_FALSE;
+	}
+
+	// First buffer is rendered to, all others are free.
+	presentQueue->renderIndex = 0;
+
+	for (i = 0; i < presentQueue->depth; i++)
+	{
+		presentQueue->released.entries[i] = i + 1;
+	}
+
+	presentQueue->released.tail = presentQueue->depth;
+
+	sem_init(&presentQueue->queued.count, 0, 0);
+	sem_init(&presentQueue->released.count, 0, (unsigned int)presentQueue->depth);
+
+	if (pthread_create(&presentQueue->thread, 0, __presentThread, presentQueue) != 0)
+	{
+		sem_destroy(&presentQueue->queued.count);
+		sem_destroy(&presentQueue->released.count);
+
+		glXDestroyContext(presentQueue->display, presentQueue->ctx);
+
+		for (i = 0; i <= presentQueue->depth; i++)
+		{
+			glXDestroyPbuffer(presentQueue->display, presentQueue->buffers[i]);
+		}
+
+		free(presentQueue);
+
+		return EGL_FALSE;
+	}
+
+	nativeSurfaceContainer->presentQueue = presentQueue;
+
+	glXMakeContextCurrent(presentQueue->display, presentQueue->buffers[0], presentQueue->buffers[0], presentQueue->sharedCtx);
+
+	return EGL_TRUE;
+}
+
+static void __submitPresentQueue(PresentQueue* presentQueue, EGLnsecsANDROID presentationTime)
+{
+	EGLint index = presentQueue->renderIndex;
+
+	presentQueue->renderFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	presentQueue->presentationTimes[index] = presentationTime;
+
+	// Otherwise, the present thread could wait for commands, which are never sent.
+	glFlush();
+
+	__pushPresentRing(&presentQueue->queued, index);
+
+	// Blocks only, if the maximum of frames is in flight.
+	index = __popPresentRing(&presentQueue->released);
+
+	presentQueue->renderIndex = index;
+
+	glXMakeContextCurrent(presentQueue->display, presentQueue->buffers[index], presentQueue->buffers[index], glXGetCurrentContext());
+
+	// The buffer may still be read by the present thread.
+	if (presentQueue->releaseFences[index])
+	{
+		glWaitSync(presentQueue->releaseFences[index], 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(presentQueue->releaseFences[index]);
+		presentQueue->releaseFences[index] = 0;
+	}
+}
+
+EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContainer)
+{
+	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->window && nativeLocalStorageContainer->ctx)
+	{
+		return EGL_TRUE;
+	}
+
+	if (nativeLocalStorageContainer->display)
+	{
+		return EGL_FALSE;
+	}
+
+	if (nativeLocalStorageContainer->window)
+	{
+		return EGL_FALSE;
+	}
+
+	if (nativeLocalStorageContainer->ctx)
+	{
+		return EGL_FALSE;
+	}
+
+	nativeLocalStorageContainer->display = XOpenDisplay(NULL);
+
+	if (!nativeLocalStorageContainer->display)
+	{
+		return EGL_FALSE;
+	}
+
+	//
+
+	int glxMajor;
+	int glxMinor;
+
+	// GLX version 1.4 or higher needed.
+	if (!glXQueryVersion(nativeLocalStorageContainer->display, &glxMajor, &glxMinor))
+	{
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+
+	if (glxMajor < 1 || (glxMajor == 1 && glxMinor < 4))
+	{
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+
+	//
+
+	nativeLocalStorageContainer->window = DefaultRootWindow(nativeLocalStorageContainer->display);
+
+	if (!nativeLocalStorageContainer->window)
+	{
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+
+	int dummyAttribList[] = {
+		GLX_USE_GL, True,
+		GLX_DOUBLEBUFFER, True,
+		GLX_RGBA, True,
+		None
+	};
+
+	XVisualInfo* visualInfo = glXChooseVisual(nativeLocalStorageContainer->display, 0, dummyAttribList);
+
+	if (!visualInfo)
+	{
+		nativeLocalStorageContainer->window = 0;
+
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+  
+	nativeLocalStorageContainer->ctx = glXCreateContext(nativeLocalStorageContainer->display, visualInfo, NULL, True);
+
+	if (!nativeLocalStorageContainer->ctx)
+	{
+		nativeLocalStorageContainer->window = 0;
+
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+
+	if (!glXMakeCurrent(nativeLocalStorageContainer->display, nativeLocalStorageContainer->window, nativeLocalStorageContainer->ctx))
+	{
+		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
+		nativeLocalStorageContainer->ctx = 0;
+
+		nativeLocalStorageContainer->window = 0;
+
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+
+#if !defined(EGL_NO_GLEW)
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GL_NO_ERROR)
+	{
+		glXMakeCurrent(nativeLocalStorageContainer->display, 0, 0);
+
+		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
+		nativeLocalStorageContainer->ctx = 0;
+
+		nativeLocalStorageContainer->window = 0;
+
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+
+		return EGL_FALSE;
+	}
+#else
+  glXCreateContextAttribsARB_PTR =
+    (__PFN_glXCreateContextAttribsARB)
+        __getProcAddress("glXCreateContextAttribsARB");
+  glXSwapIntervalEXT_PTR =
+    (__PFN_glXSwapIntervalEXT)__getProcAddress("glXSwapIntervalEXT");
+  glXBindTexImageEXT_PTR =
+    (__PFN_glXBindTexImageEXT)__getProcAddress("glXBindTexImageEXT");
+  glXReleaseTexImageEXT_PTR =
+    (__PFN_glXReleaseTexImageEXT)__getProcAddress("glXReleaseTexImageEXT");
+  glFinish_PTR = (__PFN_glFinish)__getProcAddress("glFinish");
+  glBindBuffer_PTR = (__PFN_glBindBuffer)__getProcAddress("glBindBuffer");
+  glXCopySubBufferMESA_PTR =
+    (__PFN_glXCopySubBufferMESA)__getProcAddress("glXCopySubBufferMESA");
+  glXGetSyncValuesOML_PTR =
+    (__PFN_glXGetSyncValuesOML)__getProcAddress("glXGetSyncValuesOML");
+  glXGetMscRateOML_PTR =
+    (__PFN_glXGetMscRateOML)__getProcAddress("glXGetMscRateOML");
+  glXSwapBuffersMscOML_PTR =
+    (__PFN_glXSwapBuffersMscOML)__getProcAddress("glXSwapBuffersMscOML");
+  glFenceSync_PTR = (__PFN_glFenceSync)__getProcAddress("glFenceSync");
+  glWaitSync_PTR = (__PFN_glWaitSync)__getProcAddress("glWaitSync");
+  glClientWaitSync_PTR =
+    (__PFN_glClientWaitSync)__getProcAddress("glClientWaitSync");
+  glDeleteSync_PTR = (__PFN_glDeleteSync)__getProcAddress("glDeleteSync");
+  glBlitFramebuffer_PTR =
+    (__PFN_glBlitFramebuffer)__getProcAddress("glBlitFramebuffer");
+  glGenBuffers_PTR = (__PFN_glGenBuffers)__getProcAddress("glGenBuffers");
+  glDeleteBuffers_PTR =
+    (__PFN_glDeleteBuffers)__getProcAddress("glDeleteBuffers");
+  glBufferData_PTR = (__PFN_glBufferData)__getProcAddress("glBufferData");
+  glMapBufferRange_PTR =
+    (__PFN_glMapBufferRange)__getProcAddress("glMapBufferRange");
+  glUnmapBuffer_PTR = (__PFN_glUnmapBuffer)__getProcAddress("glUnmapBuffer");
+  glBindFramebuffer_PTR =
+    (__PFN_glBindFramebuffer)__getProcAddress("glBindFramebuffer");
+  glCreateShader_PTR = (__PFN_glCreateShader)__getProcAddress("glCreateShader");
+  glShaderSource_PTR = (__PFN_glShaderSource)__getProcAddress("glShaderSource");
+  glCompileShader_PTR =
+    (__PFN_glCompileShader)__getProcAddress("glCompileShader");
+  glGetShaderiv_PTR = (__PFN_glGetShaderiv)__getProcAddress("glGetShaderiv");
+  glDeleteShader_PTR = (__PFN_glDeleteShader)__getProcAddress("glDeleteShader");
+  glCreateProgram_PTR =
+    (__PFN_glCreateProgram)__getProcAddress("glCreateProgram");
+  glAttachShader_PTR = (__PFN_glAttachShader)__getProcAddress("glAttachShader");
+  glLinkProgram_PTR = (__PFN_glLinkProgram)__getProcAddress("glLinkProgram");
+  glGetProgramiv_PTR = (__PFN_glGetProgramiv)__getProcAddress("glGetProgramiv");
+  glDeleteProgram_PTR =
+    (__PFN_glDeleteProgram)__getProcAddress("glDeleteProgram");
+  glUseProgram_PTR = (__PFN_glUseProgram)__getProcAddress("glUseProgram");
+  glGetUniformLocation_PTR =
+    (__PFN_glGetUniformLocation)__getProcAddress("glGetUniformLocation");
+  glUniform1i_PTR = (__PFN_glUniform1i)__getProcAddress("glUniform1i");
+  glUniform2i_PTR = (__PFN_glUniform2i)__getProcAddress("glUniform2i");
+  glActiveTexture_PTR =
+    (__PFN_glActiveTexture)__getProcAddress("glActiveTexture");
+  glGenFramebuffers_PTR =
+    (__PFN_glGenFramebuffers)__getProcAddress("glGenFramebuffers");
+  glDeleteFramebuffers_PTR =
+    (__PFN_glDeleteFramebuffers)__getProcAddress("glDeleteFramebuffers");
+  glFramebufferTexture2D_PTR =
+    (__PFN_glFramebufferTexture2D)__getProcAddress("glFramebufferTexture2D");
+  glGenVertexArrays_PTR =
+    (__PFN_glGenVertexArrays)__getProcAddress("glGenVertexArrays");
+  glBindVertexArray_PTR =
+    (__PFN_glBindVertexArray)__getProcAddress("glBindVertexArray");
+  glDeleteVertexArrays_PTR =
+    (__PFN_glDeleteVertexArrays)__getProcAddress("glDeleteVertexArrays");
+  glBindSampler_PTR =
+    (__PFN_glBindSampler)__getProcAddress("glBindSampler");
+  glGetStringi_PTR =
+    (__PFN_glGetStringi)__getProcAddress("glGetStringi");
+  glBufferStorage_PTR =
+    (__PFN_glBufferStorage)__getProcAddress("glBufferStorage");
+#endif
+	return EGL_TRUE;
+}
+
+EGLBoolean __internalTerminate(NativeLocalStorageContainer* nativeLocalStorageContainer)
+{
+	if (!nativeLocalStorageContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	if (nativeLocalStorageContainer->display)
+	{
+		glXMakeContextCurrent(nativeLocalStorageContainer->display, 0, 0, 0);
+	}
+
+	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->ctx)
+	{
+		glXDestroyContext(nativeLocalStorageContainer->display, nativeLocalStorageContainer->ctx);
+		nativeLocalStorageContainer->ctx = 0;
+	}
+
+	if (nativeLocalStorageContainer->display && nativeLocalStorageContainer->window)
+	{
+		XDestroyWindow(nativeLocalStorageContainer->display, nativeLocalStorageContainer->window);
+		nativeLocalStorageContainer->window = 0;
+	}
+
+	if (nativeLocalStorageContainer->display)
+	{
+		XCloseDisplay(nativeLocalStorageContainer->display);
+		nativeLocalStorageContainer->display = 0;
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextContainer* nativeContextContainer)
+{
+	if (!walkerDpy || !nativeContextContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	// Pixel buffers for copying are released together with the context.
+	EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+	while (walkerSurface)
+	{
+		if (walkerSurface->nativeSurfaceContainer.copyCtx == nativeContextContainer->ctx)
+		{
+			walkerSurface->nativeSurfaceContainer.copyBuffer = 0;
+			walkerSurface->nativeSurfaceContainer.copyBufferSize = 0;
+			walkerSurface->nativeSurfaceContainer.copyCtx = 0;
+		}
+
+		walkerSurface = walkerSurface->next;
+	}
+
+	glXDestroyContext(walkerDpy->display_id, nativeContextContainer->ctx);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __processAttribList(EGLint* target_attrib_list, const EGLint* attrib_list, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+	if (!target_attrib_list || !attrib_list || !walkerDpy || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLint template_attrib_list[] = {
+			GLX_CONTEXT_MAJOR_VERSION_ARB, 1,
+			GLX_CONTEXT_MINOR_VERSION_ARB, 0,
+			GLX_CONTEXT_FLAGS_ARB, 0,
+			GLX_CONTEXT_PROFILE_MASK_ARB, 0,
+			GLX_CONTEXT_RESET_NOTIFICATION_STRATEGY_ARB, GLX_NO_RESET_NOTIFICATION_ARB,
+			// Optional attributes, only passed when set.
+			0, 0,
+			0, 0,
+			0, 0,
+			0
+	};
+
+	EGLBoolean releaseBehaviorSet = EGL_FALSE;
+	EGLint releaseBehavior = 0;
+
+	EGLBoolean noError = EGL_FALSE;
+
+	EGLint attribListIndex = 0;
+
+	while (attrib_list[attribListIndex] != EGL_NONE)
+	{
+		EGLint value = attrib_list[attribListIndex + 1];
+
+		switch (attrib_list[attribListIndex])
+		{
+			case EGL_CONTEXT_MAJOR_VERSION:
+			{
+				if (value < 1)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				template_attrib_list[1] = value;
+			}
+			break;
+			case EGL_CONTEXT_MINOR_VERSION:
+			{
+				if (value < 0)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				template_attrib_list[3] = value;
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_PROFILE_MASK:
+			{
+				if (value == EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT)
+				{
+					template_attrib_list[7] = GLX_CONTEXT_CORE_PROFILE_BIT_ARB;
+				}
+				else if (value == EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT)
+				{
+					template_attrib_list[7] = GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_DEBUG:
+			{
+				if (value == EGL_TRUE)
+				{
+					template_attrib_list[5] |= GLX_CONTEXT_DEBUG_BIT_ARB;
+				}
+				else if (value == EGL_FALSE)
+				{
+					template_attrib_list[5] &= ~GLX_CONTEXT_DEBUG_BIT_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE:
+			{
+				if (value == EGL_TRUE)
+				{
+					template_attrib_list[5] |= GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
+				}
+				else if (value == EGL_FALSE)
+				{
+					template_attrib_list[5] &= ~GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_ROBUST_ACCESS:
+			{
+				if (value == EGL_TRUE)
+				{
+					template_attrib_list[5] |= GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+				}
+				else if (value == EGL_FALSE)
+				{
+					template_attrib_list[5] &= ~GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_RESET_NOTIFICATION_STRATEGY:
+			{
+				if (value == EGL_NO_RESET_NOTIFICATION)
+				{
+					template_attrib_list[9] = GLX_NO_RESET_NOTIFICATION_ARB;
+				}
+				else if (value == EGL_LOSE_CONTEXT_ON_RESET)
+				{
+					template_attrib_list[9] = GLX_LOSE_CONTEXT_ON_RESET_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_RELEASE_BEHAVIOR_KHR:
+			{
+				if (!walkerDpy->nativeDisplayContainer.contextFlushControl)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				if (value == EGL_CONTEXT_RELEASE_BEHAVIOR_NONE_KHR)
+				{
+					releaseBehavior = GLX_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB;
+				}
+				else if (value == EGL_CONTEXT_RELEASE_BEHAVIOR_FLUSH_KHR)
+				{
+					releaseBehavior = GLX_CONTEXT_RELEASE_BEHAVIOR_FLUSH_ARB;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				releaseBehaviorSet = EGL_TRUE;
+			}
+			break;
+			case EGL_CONTEXT_OPENGL_NO_ERROR_KHR:
+			{
+				if (!walkerDpy->nativeDisplayContainer.createContextNoError)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				if (value == EGL_TRUE)
+				{
+					noError = EGL_TRUE;
+				}
+				else if (value == EGL_FALSE)
+				{
+					noError = EGL_FALSE;
+				}
+				else
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+			{
+				if (value != EGL_CONTEXT_PRIORITY_HIGH_IMG && value != EGL_CONTEXT_PRIORITY_MEDIUM_IMG && value != EGL_CONTEXT_PRIORITY_LOW_IMG)
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			break;
+			default:
+			{
+				*error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_FALSE;
+			}
+			break;
+		}
+
+		attribListIndex += 2;
+
+		// More than 20 entries can not exist.
+		if (attribListIndex >= 10 * 2)
+		{
+			*error = EGL_BAD_ATTRIBUTE;
+
+			return EGL_FALSE;
+		}
+	}
+
+	// Errors can not be reported by a no error context.
+	if (noError && (template_attrib_list[5] & (GLX_CONTEXT_DEBUG_BIT_ARB | GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB)))
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	// Optional attributes are appended, as older drivers do not know them.
+	EGLint optionalIndex = 10;
+
+	if (releaseBehaviorSet)
+	{
+		template_attrib_list[optionalIndex++] = GLX_CONTEXT_RELEASE_BEHAVIOR_ARB;
+		template_attrib_list[optionalIndex++] = releaseBehavior;
+	}
+
+	if (noError)
+	{
+		template_attrib_list[optionalIndex++] = GLX_CONTEXT_OPENGL_NO_ERROR_ARB;
+		template_attrib_list[optionalIndex++] = True;
+	}
+
+	memcpy(target_attrib_list, template_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType win, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLint renderBuffer = walkerConfig->doubleBuffer ? EGL_BACK_BUFFER : EGL_SINGLE_BUFFER;
+
+	if (attrib_list)
+	{
+		EGLint indexAttribList = 0;
+
+		while (attrib_list[indexAttribList] != EGL_NONE)
+		{
+			EGLint value = attrib_list[indexAttribList + 1];
+
+			switch (attrib_list[indexAttribList])
+			{
+				case EGL_GL_COLORSPACE:
+				{
+					if (value == EGL_GL_COLORSPACE_LINEAR)
+					{
+						// Do nothing.
+					}
+					else if (value == EGL_GL_COLORSPACE_SRGB)
+					{
+						*error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+					else
+					{
+						*error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_FALSE;
+					}
+				}
+				break;
+				case EGL_RENDER_BUFFER:
+				{
+					if (value == EGL_SINGLE_BUFFER)
+					{
+						if (walkerConfig->doubleBuffer && !(walkerConfig->surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR))
+						{
+							*error = EGL_BAD_MATCH;
+
+							return EGL_FALSE;
+						}
+					}
+					else if (value == EGL_BACK_BUFFER)
+					{
+						if (!walkerConfig->doubleBuffer)
+						{
+							*error = EGL_BAD_MATCH;
+
+							return EGL_FALSE;
+						}
+					}
+					else
+					{
+						*error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_FALSE;
+					}
+
+					renderBuffer = value;
+				}
+				break;
+				case EGL_VG_ALPHA_FORMAT:
+				{
+					*error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+				break;
+				case EGL_VG_COLORSPACE:
+				{
+					*error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			indexAttribList += 2;
+
+			// More than 4 entries can not exist.
+			if (indexAttribList >= 4 * 2)
+			{
+				*error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_FALSE;
+			}
+		}
+	}
+
+	//
+
+	GLXFBConfig config = __getFBConfig(walkerDpy, walkerConfig);
+
+	if (!config)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	XWindowAttributes windowAttributes;
+
+	if (!XGetWindowAttributes(walkerDpy->display_id, win, &windowAttributes))
+	{
+		*error = EGL_BAD_NATIVE_WINDOW;
+
+		return EGL_FALSE;
+	}
+
+	// Resizes are tracked on the private connection, so the application keeps its own event mask.
+	if (walkerDpy->nativeDisplayContainer.eventDisplay)
+	{
+		XSelectInput(walkerDpy->nativeDisplayContainer.eventDisplay, win, StructureNotifyMask);
+		XFlush(walkerDpy->nativeDisplayContainer.eventDisplay);
+	}
+
+	newSurface->drawToWindow = EGL_TRUE;
+	newSurface->drawToPixmap = EGL_FALSE;
+	newSurface->drawToPBuffer = EGL_FALSE;
+	newSurface->doubleBuffer = walkerConfig->doubleBuffer;
+	newSurface->configId = walkerConfig->configId;
+
+	newSurface->mutableRenderBuffer = (walkerConfig->surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR) ? EGL_TRUE : EGL_FALSE;
+	newSurface->renderBuffer = renderBuffer;
+	newSurface->requestedRenderBuffer = renderBuffer;
+
+	newSurface->width = windowAttributes.width;
+	newSurface->height = windowAttributes.height;
+
+	newSurface->initialized = EGL_TRUE;
+	newSurface->destroy = EGL_FALSE;
+	newSurface->win = win;
+	newSurface->nativeSurfaceContainer.config = config;
+	newSurface->nativeSurfaceContainer.drawable = win;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	if (attrib_list)
+	{
+		EGLint indexAttribList = 0;
+
+		while (attrib_list[indexAttribList] != EGL_NONE)
+		{
+			EGLint value = attrib_list[indexAttribList + 1];
+
+			switch (attrib_list[indexAttribList])
+			{
+				case EGL_GL_COLORSPACE:
+				{
+					if (value == EGL_GL_COLORSPACE_LINEAR)
+					{
+						// Do nothing.
+					}
+					else if (value == EGL_GL_COLORSPACE_SRGB)
+					{
+						*error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+					else
+					{
+						*error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_FALSE;
+					}
+				}
+				break;
+				case EGL_VG_ALPHA_FORMAT:
+				{
+					*error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+				break;
+				case EGL_VG_COLORSPACE:
+				{
+					*error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			indexAttribList += 2;
+
+			// More than 4 entries can not exist.
+			if (indexAttribList >= 4 * 2)
+			{
+				*error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_FALSE;
+			}
+		}
+	}
+
+	//
+
+	GLXFBConfig config = __getFBConfig(walkerDpy, walkerConfig);
+
+	if (!config)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	Window root;
+	int x;
+	int y;
+	unsigned int width;
+	unsigned int height;
+	unsigned int borderWidth;
+	unsigned int depth;
+
+	// The pixmap is given by the application and may not exist.
+	ErrorTrap errorTrap;
+
+	__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+	Status status = XGetGeometry(walkerDpy->display_id, pixmap, &root, &x, &y, &width, &height, &borderWidth, &depth);
+
+	if (__endErrorTrap(&errorTrap) || !status)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	XVisualInfo* visualInfo = glXGetVisualFromFBConfig(walkerDpy->display_id, config);
+
+	if (!visualInfo)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	// The server rejects pixmaps with a different layout, so check this before.
+	if (visualInfo->depth != (int)depth)
+	{
+		XFree(visualInfo);
+
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	XFree(visualInfo);
+
+	// Rendering goes directly into the shared pixmap, so other clients see the result without a copy.
+	__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+	GLXPixmap drawable = glXCreatePixmap(walkerDpy->display_id, config, pixmap, NULL);
+
+	// The server reports e.g. a pixmap, which was destroyed meanwhile, only asynchronously.
+	if (__endErrorTrap(&errorTrap))
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	if (!drawable)
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	newSurface->drawToWindow = EGL_FALSE;
+	newSurface->drawToPixmap = EGL_TRUE;
+	newSurface->drawToPBuffer = EGL_FALSE;
+	newSurface->doubleBuffer = EGL_FALSE;
+	newSurface->configId = walkerConfig->configId;
+
+	newSurface->renderBuffer = EGL_SINGLE_BUFFER;
+	newSurface->requestedRenderBuffer = EGL_SINGLE_BUFFER;
+	newSurface->width = (EGLint)width;
+	newSurface->height = (EGLint)height;
+
+	newSurface->initialized = EGL_TRUE;
+	newSurface->destroy = EGL_FALSE;
+	newSurface->pixmap = pixmap;
+	newSurface->nativeSurfaceContainer.config = config;
+	newSurface->nativeSurfaceContainer.drawable = drawable;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	GLXFBConfig config = __getFBConfig(walkerDpy, walkerConfig);
+
+	if (!config)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	EGLint width = newSurface->width;
+	EGLint height = newSurface->height;
+
+	if (newSurface->largestPBuffer)
+	{
+		if (walkerConfig->maxPBufferWidth > 0 && width > walkerConfig->maxPBufferWidth)
+		{
+			width = walkerConfig->maxPBufferWidth;
+		}
+
+		if (walkerConfig->maxPBufferHeight > 0 && height > walkerConfig->maxPBufferHeight)
+		{
+			height = walkerConfig->maxPBufferHeight;
+		}
+	}
+
+	GLXDrawable drawable = 0;
+
+	Pixmap pixmap = 0;
+
+	EGLint value;
+
+	// A pixmap can be bound as a texture without copying, so use it as backing of a bindable pbuffer.
+	if (newSurface->textureFormat != EGL_NO_TEXTURE && walkerDpy->nativeDisplayContainer.textureFromPixmap && walkerConfig->drawToPixmap && !glXGetFBConfigAttrib(walkerDpy->display_id, config, GLX_BIND_TO_TEXTURE_TARGETS_EXT, &value) && (value & GLX_TEXTURE_2D_BIT_EXT))
+	{
+		XVisualInfo* visualInfo = glXGetVisualFromFBConfig(walkerDpy->display_id, config);
+
+		if (!visualInfo)
+		{
+			*error = EGL_BAD_MATCH;
+
+			return EGL_FALSE;
+		}
+
+		// Pixmaps can not be empty.
+		pixmap = XCreatePixmap(walkerDpy->display_id, RootWindow(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id)), width > 0 ? width : 1, height > 0 ? height : 1, visualInfo->depth);
+
+		XFree(visualInfo);
+
+		if (!pixmap)
+		{
+			*error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+
+		int pixmapAttribList[] = {
+			GLX_TEXTURE_TARGET_EXT, GLX_TEXTURE_2D_EXT,
+			GLX_TEXTURE_FORMAT_EXT, newSurface->textureFormat == EGL_TEXTURE_RGBA ? GLX_TEXTURE_FORMAT_RGBA_EXT : GLX_TEXTURE_FORMAT_RGB_EXT,
+			None
+		};
+
+		drawable = glXCreatePixmap(walkerDpy->display_id, config, pixmap, pixmapAttribList);
+
+		if (!drawable)
+		{
+			XFreePixmap(walkerDpy->display_id, pixmap);
+
+			*error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+	}
+	else
+	{
+		int pbufferAttribList[] = {
+			GLX_PBUFFER_WIDTH, width,
+			GLX_PBUFFER_HEIGHT, height,
+			GLX_LARGEST_PBUFFER, newSurface->largestPBuffer ? True : False,
+			GLX_PRESERVED_CONTENTS, True,
+			None
+		};
+
+		drawable = glXCreatePbuffer(walkerDpy->display_id, config, pbufferAttribList);
+
+		if (!drawable)
+		{
+			*error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+
+		// The server may have chosen a smaller size.
+		if (newSurface->largestPBuffer)
+		{
+			unsigned int drawableValue;
+
+			glXQueryDrawable(walkerDpy->display_id, drawable, GLX_WIDTH, &drawableValue);
+			width = (EGLint)drawableValue;
+
+			glXQueryDrawable(walkerDpy->display_id, drawable, GLX_HEIGHT, &drawableValue);
+			height = (EGLint)drawableValue;
+		}
+	}
+
+	newSurface->drawToWindow = EGL_FALSE;
+	newSurface->drawToPixmap = EGL_FALSE;
+	newSurface->drawToPBuffer = EGL_TRUE;
+	newSurface->doubleBuffer = walkerConfig->doubleBuffer;
+	newSurface->configId = walkerConfig->configId;
+	newSurface->width = width;
+	newSurface->height = height;
+
+	newSurface->initialized = EGL_TRUE;
+	newSurface->destroy = EGL_FALSE;
+	newSurface->win = 0;
+	newSurface->nativeSurfaceContainer.config = config;
+	newSurface->nativeSurfaceContainer.drawable = drawable;
+	newSurface->nativeSurfaceContainer.pixmap = pixmap;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __destroySurface(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// The present thread still uses the window.
+	__destroyPresentQueue(&walkerSurface->nativeSurfaceContainer);
+
+	// The lock context is shared with other surfaces and destroyed together with the display.
+	walkerSurface->nativeSurfaceContainer.lockCtx = 0;
+
+	if (walkerSurface->drawToPixmap)
+	{
+		// The native pixmap is owned by the application.
+		glXDestroyPixmap(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable);
+
+		walkerSurface->nativeSurfaceContainer.drawable = 0;
+	}
+	else if (walkerSurface->drawToPBuffer)
+	{
+		if (walkerSurface->nativeSurfaceContainer.pixmap)
+		{
+			glXDestroyPixmap(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable);
+
+			XFreePixmap(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.pixmap);
+			walkerSurface->nativeSurfaceContainer.pixmap = 0;
+		}
+		else
+		{
+			glXDestroyPbuffer(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable);
+		}
+
+		walkerSurface->nativeSurfaceContainer.drawable = 0;
+	}
+
+	else if (walkerSurface->drawToWindow && walkerDpy->nativeDisplayContainer.eventDisplay)
+	{
+		Display* eventDisplay = walkerDpy->nativeDisplayContainer.eventDisplay;
+
+		// The window may already be destroyed by the application.
+		ErrorTrap errorTrap;
+
+		__beginErrorTrap(eventDisplay, &errorTrap);
+
+		XSelectInput(eventDisplay, walkerSurface->win, NoEventMask);
+
+		__endErrorTrap(&errorTrap);
+
+		XEvent event;
+
+		while (XCheckWindowEvent(eventDisplay, walkerSurface->win, StructureNotifyMask, &event))
+		{
+			// Discard pending events.
+		}
+	}
+
+	__destroyStagingImage(walkerDpy, &walkerSurface->nativeSurfaceContainer);
+
+	// The pixel buffer can only be deleted by its context. Otherwise, it is released together with it.
+	if (walkerSurface->nativeSurfaceContainer.copyBuffer && walkerSurface->nativeSurfaceContainer.copyCtx == glXGetCurrentContext())
+	{
+		glDeleteBuffers(1, &walkerSurface->nativeSurfaceContainer.copyBuffer);
+	}
+
+	walkerSurface->nativeSurfaceContainer.copyBuffer = 0;
+	walkerSurface->nativeSurfaceContainer.copyBufferSize = 0;
+	walkerSurface->nativeSurfaceContainer.copyCtx = 0;
+
+	// The native window is owned by the application.
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __updateSurfaceSize(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	Display* eventDisplay = walkerDpy->nativeDisplayContainer.eventDisplay;
+
+	if (!eventDisplay)
+	{
+		// Without the private connection, the size has to be requested every time.
+		XWindowAttributes windowAttributes;
+
+		if (!XGetWindowAttributes(walkerDpy->display_id, walkerSurface->win, &windowAttributes))
+		{
+			return EGL_FALSE;
+		}
+
+		walkerSurface->width = windowAttributes.width;
+		walkerSurface->height = windowAttributes.height;
+
+		return EGL_TRUE;
+	}
+
+	// Only reads, what the server already did send. No round trip is done.
+	if (!XEventsQueued(eventDisplay, QueuedAfterReading))
+	{
+		return EGL_TRUE;
+	}
+
+	XEvent event;
+
+	while (XCheckWindowEvent(eventDisplay, walkerSurface->win, StructureNotifyMask, &event))
+	{
+		if (event.type == ConfigureNotify)
+		{
+			walkerSurface->width = event.xconfigure.width;
+			walkerSurface->height = event.xconfigure.height;
+		}
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageContainer* nativeLocalStorageContainer, EGLint* error)
+{
+	if (!walkerDpy || !nativeLocalStorageContainer || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	// Create configuration list.
+
+	EGLint numberPixelFormats;
+
+	GLXFBConfig* fbConfigs = glXGetFBConfigs(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), &numberPixelFormats);
+
+	if (!fbConfigs || numberPixelFormats == 0)
+	{
+		if (fbConfigs)
+		{
+			XFree(fbConfigs);
+		}
+
+		*error = EGL_NOT_INITIALIZED;
+
+		return EGL_FALSE;
+	}
+
+	EGLint attribute;
+
+	XVisualInfo* visualInfo;
+
+	EGLConfigImpl* lastConfig = 0;
+	for (EGLint currentPixelFormat = 0; currentPixelFormat < numberPixelFormats; currentPixelFormat++)
+	{
+		EGLint value;
+
+		attribute = GLX_VISUAL_ID;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		if (!value)
+		{
+			continue;
+		}
+
+		// No check for OpenGL.
+
+		attribute = GLX_RENDER_TYPE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		if (!(value & GLX_RGBA_BIT))
+		{
+			continue;
+		}
+
+		attribute = GLX_TRANSPARENT_TYPE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		if (value == GLX_TRANSPARENT_INDEX)
+		{
+			continue;
+		}
+
+		//
+
+		EGLConfigImpl* newConfig = (EGLConfigImpl*)malloc(sizeof(EGLConfigImpl));
+		if (!newConfig)
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		_eglInternalSetDefaultConfig(newConfig);
+
+		// Store in the same order as received.
+		newConfig->next = 0;
+		if (lastConfig != 0)
+		{
+			lastConfig->next = newConfig;
+		}
+		else
+		{
+			walkerDpy->rootConfig = newConfig;
+		}
+		lastConfig = newConfig;
+
+		//
+
+		attribute = GLX_DRAWABLE_TYPE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		newConfig->drawToWindow = value & GLX_WINDOW_BIT ? EGL_TRUE : EGL_FALSE;
+		newConfig->drawToPixmap = value & GLX_PIXMAP_BIT ? EGL_TRUE : EGL_FALSE;
+		newConfig->drawToPBuffer = value & GLX_PBUFFER_BIT ? EGL_TRUE : EGL_FALSE;
+
+		attribute = GLX_DOUBLEBUFFER;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->doubleBuffer))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		//
+
+		newConfig->conformant = EGL_OPENGL_BIT;
+		newConfig->renderableType = EGL_OPENGL_BIT;
+		newConfig->surfaceType = 0;
+		if (newConfig->drawToWindow)
+		{
+			newConfig->surfaceType |= EGL_WINDOW_BIT;
+		}
+		if (newConfig->drawToPixmap)
+		{
+			newConfig->surfaceType |= EGL_PIXMAP_BIT;
+		}
+		if (newConfig->drawToPBuffer)
+		{
+			newConfig->surfaceType |= EGL_PBUFFER_BIT;
+		}
+		// Rendering to the front buffer of a double buffered window is done by changing the draw buffer.
+		if (newConfig->drawToWindow && newConfig->doubleBuffer)
+		{
+			newConfig->surfaceType |= EGL_MUTABLE_RENDER_BUFFER_BIT_KHR;
+		}
+		newConfig->colorBufferType = EGL_RGB_BUFFER;
+		newConfig->configId = currentPixelFormat;
+
+		// The real maximum is only known per drawable.
+		newConfig->minSwapInterval = 0;
+		newConfig->maxSwapInterval = MAX_SWAP_INTERVAL;
+
+		attribute = GLX_BUFFER_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bufferSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_RED_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->redSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_GREEN_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->greenSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_BLUE_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->blueSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_ALPHA_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->alphaSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_DEPTH_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->depthSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_STENCIL_SIZE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->stencilSize))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+
+		//
+
+		attribute = GLX_SAMPLE_BUFFERS;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->sampleBuffers))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_SAMPLES;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->samples))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		// The bitmap of a locked surface is blitted back, which is not possible into a multisampled color buffer.
+		if (newConfig->sampleBuffers == 0)
+		{
+			newConfig->surfaceType |= EGL_LOCK_SURFACE_BIT_KHR;
+
+			// Pixels are converted to 32 bits by the GL, which is exact for 8 bits per component.
+			newConfig->matchFormat = (newConfig->redSize == 8 && newConfig->greenSize == 8 && newConfig->blueSize == 8 && newConfig->alphaSize == 8) ? EGL_FORMAT_RGBA_8888_EXACT_KHR : EGL_FORMAT_RGBA_8888_KHR;
+		}
+
+		//
+
+		attribute = GLX_BIND_TO_TEXTURE_RGB_EXT;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGB))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		newConfig->bindToTextureRGB = newConfig->bindToTextureRGB ? EGL_TRUE : EGL_FALSE;
+
+		attribute = GLX_BIND_TO_TEXTURE_RGBA_EXT;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGBA))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		newConfig->bindToTextureRGBA = newConfig->bindToTextureRGBA ? EGL_TRUE : EGL_FALSE;
+
+		//
+
+		attribute = GLX_MAX_PBUFFER_PIXELS;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferPixels))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_MAX_PBUFFER_WIDTH;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferWidth))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_MAX_PBUFFER_HEIGHT;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferHeight))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		//
+
+		attribute = GLX_TRANSPARENT_TYPE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentType))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+		newConfig->transparentType = newConfig->transparentType == GLX_TRANSPARENT_RGB ? EGL_TRANSPARENT_RGB : EGL_NONE;
+
+		attribute = GLX_TRANSPARENT_RED_VALUE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentRedValue))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_TRANSPARENT_GREEN_VALUE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentGreenValue))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		attribute = GLX_TRANSPARENT_BLUE_VALUE;
+		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentBlueValue))
+		{
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		//
+
+		visualInfo = glXGetVisualFromFBConfig(walkerDpy->display_id, fbConfigs[currentPixelFormat]);
+
+		if (!visualInfo)
 		{
-			continue;
+			XFree(fbConfigs);
+
+			*error = EGL_NOT_INITIALIZED;
+
+			return EGL_FALSE;
+		}
+
+		newConfig->nativeVisualId = visualInfo->visualid;
+
+		XFree(visualInfo);
+
+		// FIXME: Query and save more values.
+	}
+
+	XFree(fbConfigs);
+
+	//
+
+	const char* glxExtensions = glXQueryExtensionsString(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id));
+
+	walkerDpy->nativeDisplayContainer.textureFromPixmap = __hasExtension(glxExtensions, "GLX_EXT_texture_from_pixmap");
+
+	if (walkerDpy->nativeDisplayContainer.textureFromPixmap)
+	{
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_image_base");
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_image_pixmap");
+	}
+
+	walkerDpy->nativeDisplayContainer.copySubBuffer = __hasExtension(glxExtensions, "GLX_MESA_copy_sub_buffer");
+	walkerDpy->nativeDisplayContainer.bufferAge = __hasExtension(glxExtensions, "GLX_EXT_buffer_age");
+	walkerDpy->nativeDisplayContainer.swapControl = __hasExtension(glxExtensions, "GLX_EXT_swap_control");
+	walkerDpy->nativeDisplayContainer.swapControlTear = __hasExtension(glxExtensions, "GLX_EXT_swap_control_tear");
+
+	walkerDpy->nativeDisplayContainer.contextFlushControl = __hasExtension(glxExtensions, "GLX_ARB_context_flush_control");
+
+	if (walkerDpy->nativeDisplayContainer.contextFlushControl)
+	{
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_context_flush_control");
+	}
+
+	walkerDpy->nativeDisplayContainer.createContextNoError = __hasExtension(glxExtensions, "GLX_ARB_create_context_no_error");
+
+	if (walkerDpy->nativeDisplayContainer.createContextNoError)
+	{
+		_eglInternalAddExtension(walkerDpy, "EGL_KHR_create_context_no_error");
+	}
+
+	// Without it, the presentation time is met by sleeping before the swap.
+	walkerDpy->nativeDisplayContainer.syncControl = __hasExtension(glxExtensions, "GLX_OML_sync_control");
+
+	_eglInternalAddExtension(walkerDpy, "EGL_ANDROID_presentation_time");
+
+	walkerDpy->nativeDisplayContainer.sharedMemory = XShmQueryExtension(walkerDpy->display_id);
+
+	// The attribute is passed to eglGetPlatformDisplay, which only accepts X11 displays.
+	_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_no_validation");
+
+	// Support of a surface is checked, when the depth is set.
+	_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_present_queue");
+
+#if defined(__linux__)
+	// Shared memory and futexes are provided by the kernel.
+	_eglInternalAddExtension(walkerDpy, "EGL_DESKTOP_frame_ring");
+#endif
+
+	// If the connection fails, window sizes are requested on demand.
+	walkerDpy->nativeDisplayContainer.eventDisplay = XOpenDisplay(DisplayString(walkerDpy->display_id));
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __terminate(EGLDisplayImpl* walkerDpy)
+{
+	if (!walkerDpy)
+	{
+		return EGL_FALSE;
+	}
+
+	if (walkerDpy->nativeDisplayContainer.eventDisplay)
+	{
+		XCloseDisplay(walkerDpy->nativeDisplayContainer.eventDisplay);
+
+		walkerDpy->nativeDisplayContainer.eventDisplay = 0;
+	}
+
+	// Objects of surfaces, which were not destroyed, are released together with the lock contexts.
+	LockContext* lockCtx = walkerDpy->nativeDisplayContainer.rootLockCtx;
+
+	while (lockCtx)
+	{
+		LockContext* nextLockCtx = lockCtx->next;
+
+		glXDestroyContext(walkerDpy->display_id, lockCtx->ctx);
+		free(lockCtx);
+
+		lockCtx = nextLockCtx;
+	}
+
+	walkerDpy->nativeDisplayContainer.rootLockCtx = 0;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+{
+	if (!nativeContextContainer || !walkerDpy || !nativeSurfaceContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	nativeContextContainer->ctx = glXCreateContextAttribsARB(walkerDpy->display_id, nativeSurfaceContainer->config, sharedNativeContextContainer ? sharedNativeContextContainer->ctx : 0, True, attribList);
+
+	return nativeContextContainer->ctx != 0;
+}
+
+EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+{
+	if (!walkerDpy || !nativeSurfaceContainer || !nativeContextContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	const PresentQueue* presentQueue = nativeSurfaceContainer->presentQueue;
+
+	// The present thread owns the window, so rendering goes to the acquired buffer.
+	if (presentQueue)
+	{
+		return (EGLBoolean)glXMakeContextCurrent(walkerDpy->display_id, presentQueue->buffers[presentQueue->renderIndex], presentQueue->buffers[presentQueue->renderIndex], nativeContextContainer->ctx);
+	}
+
+	return (EGLBoolean)glXMakeCurrent(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeContextContainer->ctx);
+}
+
+EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
+
+	PresentQueue* presentQueue = nativeSurfaceContainer->presentQueue;
+
+	if (presentQueue)
+	{
+		// Only the rendering context, which renders to the acquired buffer, can submit the frame.
+		if (glXGetCurrentDrawable() != presentQueue->buffers[presentQueue->renderIndex])
+		{
+			return EGL_FALSE;
+		}
+
+		__updateSurfaceSize(walkerDpy, walkerSurface);
+
+		__submitPresentQueue(presentQueue, walkerSurface->presentationTime);
+
+		// Content of the acquired buffer is not tracked.
+		walkerSurface->bufferAge = 0;
+
+		if (presentQueue->depth == walkerSurface->presentQueueDepth && presentQueue->width == walkerSurface->width && presentQueue->height == walkerSurface->height && presentQueue->sharedCtx == glXGetCurrentContext())
+		{
+			return EGL_TRUE;
+		}
+
+		// Depth, size or context did change, so the queue is drained and created again.
+		__destroyPresentQueue(nativeSurfaceContainer);
+	}
+	else
+	{
+		__presentWindow(walkerDpy->display_id, nativeSurfaceContainer->drawable, walkerDpy->nativeDisplayContainer.syncControl, walkerSurface->presentationTime);
+
+		// Content of a new back buffer is unknown, but single buffers always keep it.
+		walkerSurface->bufferAge = walkerSurface->doubleBuffer ? 0 : 1;
+	}
+
+	// Following frames are presented by the present thread.
+	if (walkerSurface->presentQueueDepth > 0 && glXGetCurrentDrawable() == nativeSurfaceContainer->drawable)
+	{
+		if (!__createPresentQueue(walkerDpy, walkerSurface))
+		{
+			walkerSurface->presentQueueDepth = 0;
 		}
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __swapBuffersWithDamage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+	if (!walkerDpy || !walkerSurface || !rects)
+	{
+		return EGL_FALSE;
+	}
+
+	if (!walkerDpy->nativeDisplayContainer.copySubBuffer || !walkerSurface->doubleBuffer || walkerSurface->nativeSurfaceContainer.presentQueue)
+	{
+		return __swapBuffers(walkerDpy, walkerSurface);
+	}
+
+	// Both EGL and GLX rectangles have their origin at the lower left.
+	EGLint indexRect;
+
+	for (indexRect = 0; indexRect < n_rects; indexRect++)
+	{
+		const EGLint* rect = &rects[indexRect * 4];
+
+		glXCopySubBufferMESA(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, rect[0], rect[1], rect[2], rect[3]);
+	}
+
+	// The back buffer is not exchanged, so it still holds the presented frame.
+	walkerSurface->bufferAge = 1;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __flushSwaps(const EGLDisplayImpl* walkerDpy)
+{
+	if (!walkerDpy)
+	{
+		return EGL_FALSE;
+	}
+
+	XFlush(walkerDpy->display_id);
+
+	return EGL_TRUE;
+}
+
+EGLint __queryBufferAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return 0;
+	}
+
+	if (walkerSurface->bufferAge > 0)
+	{
+		return walkerSurface->bufferAge;
+	}
+
+	// Rendering does not go to the window.
+	if (!walkerDpy->nativeDisplayContainer.bufferAge || walkerSurface->nativeSurfaceContainer.presentQueue)
+	{
+		return 0;
+	}
+
+	unsigned int age = 0;
+
+	glXQueryDrawable(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, GLX_BACK_BUFFER_AGE_EXT, &age);
+
+	return (EGLint)age;
+}
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// Without swap control, the interval of the server is kept.
+	if (!walkerDpy->nativeDisplayContainer.swapControl)
+	{
+		return EGL_TRUE;
+	}
+
+	PresentQueue* presentQueue = walkerSurface->nativeSurfaceContainer.presentQueue;
+
+	// The present thread applies the interval to the window, as it presents the frames.
+	if (presentQueue)
+	{
+		__atomic_store_n(&presentQueue->swapInterval, __getNativeSwapInterval(walkerDpy, interval), __ATOMIC_RELAXED);
+
+		return EGL_TRUE;
+	}
+
+	glXSwapIntervalEXT(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, __getNativeSwapInterval(walkerDpy, interval));
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __hasPresentQueue(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	// Frames are handed over with fences and blitted to the window.
+#if defined(EGL_NO_GLEW)
+	if (!glFenceSync_PTR || !glWaitSync_PTR || !glDeleteSync_PTR || !glBlitFramebuffer_PTR)
+#else
+	if (!glFenceSync || !glWaitSync || !glDeleteSync || !glBlitFramebuffer)
+#endif
+	{
+		return EGL_FALSE;
+	}
+
+	int drawableType;
+
+	if (glXGetFBConfigAttrib(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.config, GLX_DRAWABLE_TYPE, &drawableType) || !(drawableType & GLX_PBUFFER_BIT))
+	{
+		return EGL_FALSE;
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __getPresentCounter(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* counter, EGLnsecsANDROID* time)
+{
+	if (!walkerDpy || !walkerSurface || !counter || !time)
+	{
+		return EGL_FALSE;
+	}
+
+	if (!walkerDpy->nativeDisplayContainer.syncControl)
+	{
+		return EGL_FALSE;
+	}
+
+	int64_t ust;
+	int64_t msc;
+	int64_t sbc;
+
+	if (!glXGetSyncValuesOML(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, &ust, &msc, &sbc))
+	{
+		return EGL_FALSE;
+	}
+
+	*counter = (EGLuint64KHR)sbc;
+
+	// Latest vertical blank in microseconds of the monotonic clock.
+	*time = (EGLnsecsANDROID)ust * 1000;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createImage(EGLImageImpl* newImage, EGLenum target, EGLClientBuffer buffer, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+	if (!newImage || !walkerDpy || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	if (target != EGL_NATIVE_PIXMAP_KHR || !walkerDpy->nativeDisplayContainer.textureFromPixmap)
+	{
+		*error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	Pixmap pixmap = (Pixmap)buffer;
+
+	if (!pixmap)
+	{
+		*error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	Window root;
+	int x;
+	int y;
+	unsigned int width;
+	unsigned int height;
+	unsigned int borderWidth;
+	unsigned int depth;
+
+	// The pixmap is given by the application and may not exist.
+	ErrorTrap errorTrap;
+
+	__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+	Status status = XGetGeometry(walkerDpy->display_id, pixmap, &root, &x, &y, &width, &height, &borderWidth, &depth);
+
+	if (__endErrorTrap(&errorTrap) || !status)
+	{
+		*error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	// Only a depth of 32 bits does carry alpha.
+	EGLint textureFormat = depth == 32 ? GLX_TEXTURE_FORMAT_RGBA_EXT : GLX_TEXTURE_FORMAT_RGB_EXT;
+
+	int configAttribList[] = {
+		GLX_DRAWABLE_TYPE, GLX_PIXMAP_BIT,
+		GLX_BIND_TO_TEXTURE_TARGETS_EXT, GLX_TEXTURE_2D_BIT_EXT,
+		textureFormat == GLX_TEXTURE_FORMAT_RGBA_EXT ? GLX_BIND_TO_TEXTURE_RGBA_EXT : GLX_BIND_TO_TEXTURE_RGB_EXT, True,
+		None
+	};
 
-		// No check for OpenGL.
+	EGLint numberPixelFormats;
 
-		attribute = GLX_RENDER_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+	GLXFBConfig* fbConfigs = glXChooseFBConfig(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), configAttribList, &numberPixelFormats);
 
-			return EGL_FALSE;
-		}
-		if (!(value & GLX_RGBA_BIT))
+	if (!fbConfigs || numberPixelFormats == 0)
+	{
+		if (fbConfigs)
 		{
-			continue;
+			XFree(fbConfigs);
 		}
 
-		attribute = GLX_TRANSPARENT_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+		*error = EGL_BAD_MATCH;
 
-			return EGL_FALSE;
-		}
-		if (value == GLX_TRANSPARENT_INDEX)
-		{
-			continue;
-		}
+		return EGL_FALSE;
+	}
 
-		//
+	XVisualInfo* visualInfo;
+
+	GLXFBConfig config = 0;
 
+	for (EGLint currentPixelFormat = 0; currentPixelFormat < numberPixelFormats; currentPixelFormat++)
+	{
 		visualInfo = glXGetVisualFromFBConfig(walkerDpy->display_id, fbConfigs[currentPixelFormat]);
 
 		if (!visualInfo)
 		{
-			XFree(fbConfigs);
-
-			return EGL_FALSE;
+			continue;
 		}
 
-		if (walkerConfig->nativeVisualId == visualInfo->visualid)
+		// The configuration has to match the layout of the pixmap.
+		if (visualInfo->depth == (int)depth)
 		{
 			config = fbConfigs[currentPixelFormat];
 
@@ -573,444 +2719,686 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 
 	if (!config)
 	{
+		*error = EGL_BAD_MATCH;
+
 		return EGL_FALSE;
 	}
 
-	newSurface->drawToWindow = EGL_TRUE;
-	newSurface->drawToPixmap = EGL_FALSE;
-	newSurface->drawToPixmap = EGL_FALSE;
-	newSurface->doubleBuffer = walkerConfig->doubleBuffer;
-	newSurface->configId = walkerConfig->configId;
+	int pixmapAttribList[] = {
+		GLX_TEXTURE_TARGET_EXT, GLX_TEXTURE_2D_EXT,
+		GLX_TEXTURE_FORMAT_EXT, textureFormat,
+		None
+	};
 
-	newSurface->initialized = EGL_TRUE;
-	newSurface->destroy = EGL_FALSE;
-	newSurface->win = win;
-	newSurface->nativeSurfaceContainer.config = config;
-	newSurface->nativeSurfaceContainer.drawable = win;
+	GLXPixmap drawable = glXCreatePixmap(walkerDpy->display_id, config, pixmap, pixmapAttribList);
+
+	if (!drawable)
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	newImage->width = (EGLint)width;
+	newImage->height = (EGLint)height;
+	newImage->nativeImageContainer.drawable = drawable;
+	newImage->nativeImageContainer.config = config;
+	newImage->nativeImageContainer.bound = False;
 
 	return EGL_TRUE;
 }
 
-EGLBoolean __destroySurface(EGLNativeWindowType win, const NativeSurfaceContainer* nativeSurfaceContainer)
+EGLBoolean __destroyImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage)
 {
-	if (!nativeSurfaceContainer)
+	if (!walkerDpy || !walkerImage)
 	{
 		return EGL_FALSE;
 	}
 
-	// Nothing to release.
+	// Releasing is only possible with a current context. Otherwise, the texture content becomes undefined.
+	if (walkerImage->nativeImageContainer.bound && glXGetCurrentContext())
+	{
+		glXReleaseTexImageEXT(walkerDpy->display_id, walkerImage->nativeImageContainer.drawable, GLX_FRONT_LEFT_EXT);
+	}
+	walkerImage->nativeImageContainer.bound = False;
+
+	glXDestroyPixmap(walkerDpy->display_id, walkerImage->nativeImageContainer.drawable);
+	walkerImage->nativeImageContainer.drawable = 0;
 
 	return EGL_TRUE;
 }
 
-EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageContainer* nativeLocalStorageContainer, EGLint* error)
+EGLBoolean __bindImage(const EGLDisplayImpl* walkerDpy, EGLImageImpl* walkerImage, GLenum target)
 {
-	if (!walkerDpy || !nativeLocalStorageContainer || !error)
+	if (!walkerDpy || !walkerImage)
 	{
 		return EGL_FALSE;
 	}
 
-	// Create configuration list.
+	if (target != GL_TEXTURE_2D)
+	{
+		return EGL_FALSE;
+	}
 
-	EGLint numberPixelFormats;
+	// Binding again does pick up the current content of the pixmap.
+	if (walkerImage->nativeImageContainer.bound)
+	{
+		glXReleaseTexImageEXT(walkerDpy->display_id, walkerImage->nativeImageContainer.drawable, GLX_FRONT_LEFT_EXT);
+	}
 
-	GLXFBConfig* fbConfigs = glXGetFBConfigs(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), &numberPixelFormats);
+	glXBindTexImageEXT(walkerDpy->display_id, walkerImage->nativeImageContainer.drawable, GLX_FRONT_LEFT_EXT, NULL);
 
-	if (!fbConfigs || numberPixelFormats == 0)
+	walkerImage->nativeImageContainer.bound = True;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error)
+{
+	if (!walkerDpy || !walkerSurface || !error)
 	{
-		if (fbConfigs)
-		{
-			XFree(fbConfigs);
-		}
+		return EGL_FALSE;
+	}
 
-		*error = EGL_NOT_INITIALIZED;
+	Window root;
+	int x, y;
+	unsigned int width, height, borderWidth, depth;
+
+	// The pixmap is given by the application and may not exist.
+	ErrorTrap errorTrap;
+
+	__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+	Status status = XGetGeometry(walkerDpy->display_id, (Pixmap)target, &root, &x, &y, &width, &height, &borderWidth, &depth);
+
+	if (__endErrorTrap(&errorTrap) || !status)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
 
 		return EGL_FALSE;
 	}
 
-	EGLint attribute;
+	// Only the common 32 bit layouts are converted.
+	if (depth != 24 && depth != 32)
+	{
+		*error = EGL_BAD_MATCH;
 
-	XVisualInfo* visualInfo;
+		return EGL_FALSE;
+	}
 
-	EGLConfigImpl* lastConfig = 0;
-	for (EGLint currentPixelFormat = 0; currentPixelFormat < numberPixelFormats; currentPixelFormat++)
+	GLXDrawable drawable = walkerSurface->nativeSurfaceContainer.drawable;
+
+	unsigned int surfaceWidth = 0;
+	unsigned int surfaceHeight = 0;
+
+	glXQueryDrawable(walkerDpy->display_id, drawable, GLX_WIDTH, &surfaceWidth);
+	glXQueryDrawable(walkerDpy->display_id, drawable, GLX_HEIGHT, &surfaceHeight);
+
+	if (surfaceWidth < width)
 	{
-		EGLint value;
+		width = surfaceWidth;
+	}
+	if (surfaceHeight < height)
+	{
+		height = surfaceHeight;
+	}
 
-		attribute = GLX_VISUAL_ID;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+	if (width == 0 || height == 0)
+	{
+		return EGL_TRUE;
+	}
 
-			*error = EGL_NOT_INITIALIZED;
+	XImage* image = __createStagingImage(walkerDpy, &walkerSurface->nativeSurfaceContainer, depth, width, height);
 
-			return EGL_FALSE;
-		}
-		if (!value)
-		{
-			continue;
-		}
+	if (!image)
+	{
+		*error = EGL_BAD_ALLOC;
 
-		// No check for OpenGL.
+		return EGL_FALSE;
+	}
 
-		attribute = GLX_RENDER_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+	if (image->bits_per_pixel != 32 || image->byte_order != LSBFirst || image->red_mask != 0xff0000 || image->green_mask != 0x00ff00 || image->blue_mask != 0x0000ff)
+	{
+		*error = EGL_BAD_MATCH;
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
-		if (!(value & GLX_RGBA_BIT))
-		{
-			continue;
-		}
+	// The staging image matches the layout of the pixmap, so no conversion is needed.
 
-		attribute = GLX_TRANSPARENT_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
 
-			*error = EGL_NOT_INITIALIZED;
+	GLsizeiptr size = (GLsizeiptr)image->bytes_per_line * (GLsizeiptr)height;
 
-			return EGL_FALSE;
-		}
-		if (value == GLX_TRANSPARENT_INDEX)
-		{
-			continue;
-		}
+	EGLBoolean pixelBuffers = __hasPixelBuffers();
 
-		//
+	GLXContext ctx = glXGetCurrentContext();
+	GLXDrawable currentRead = glXGetCurrentReadDrawable();
 
-		EGLConfigImpl* newConfig = (EGLConfigImpl*)malloc(sizeof(EGLConfigImpl));
-		if (!newConfig)
+	if (currentRead != drawable)
+	{
+		glXMakeContextCurrent(walkerDpy->display_id, drawable, drawable, ctx);
+	}
+
+	GLint packBuffer;
+	GLint packAlignment;
+	GLint packRowLength;
+	GLint readBuffer;
+
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glPixelStorei(GL_PACK_ROW_LENGTH, image->bytes_per_line / 4);
+	glReadBuffer(walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT);
+
+	GC gc = 0;
+
+	const char* pixels = 0;
+
+	if (pixelBuffers)
+	{
+		// Buffers of another context can not be used here. So the previous context deletes its buffer, as it did already render to the drawable.
+		if (nativeSurfaceContainer->copyCtx != ctx)
 		{
-			XFree(fbConfigs);
+			if (nativeSurfaceContainer->copyBuffer)
+			{
+				// The previous context may be current to another thread. Then its buffer is released together with it.
+				__beginErrorTrap(walkerDpy->display_id, &errorTrap);
 
-			*error = EGL_NOT_INITIALIZED;
+				Bool previousCurrent = glXMakeContextCurrent(walkerDpy->display_id, drawable, drawable, nativeSurfaceContainer->copyCtx);
 
-			return EGL_FALSE;
+				if (!__endErrorTrap(&errorTrap) && previousCurrent)
+				{
+					glDeleteBuffers(1, &nativeSurfaceContainer->copyBuffer);
+				}
+
+				glXMakeContextCurrent(walkerDpy->display_id, drawable, drawable, ctx);
+			}
+
+			nativeSurfaceContainer->copyBuffer = 0;
+			nativeSurfaceContainer->copyBufferSize = 0;
+			nativeSurfaceContainer->copyCtx = ctx;
 		}
-		_eglInternalSetDefaultConfig(newConfig);
 
-		// Store in the same order as received.
-		newConfig->next = 0;
-		if (lastConfig != 0)
+		if (!nativeSurfaceContainer->copyBuffer)
 		{
-			lastConfig->next = newConfig;
+			glGenBuffers(1, &nativeSurfaceContainer->copyBuffer);
 		}
-		else
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, nativeSurfaceContainer->copyBuffer);
+
+		if (nativeSurfaceContainer->copyBufferSize < size)
 		{
-			walkerDpy->rootConfig = newConfig;
+			glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_STREAM_READ);
+
+			nativeSurfaceContainer->copyBufferSize = size;
 		}
-		lastConfig = newConfig;
 
-		//
+		// Reading into the pixel buffer returns immediately, so the pixmap is prepared meanwhile.
+		glReadPixels(0, 0, (GLsizei)width, (GLsizei)height, GL_BGRA, GL_UNSIGNED_BYTE, 0);
 
-		attribute = GLX_DRAWABLE_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &value))
-		{
-			XFree(fbConfigs);
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
-			*error = EGL_NOT_INITIALIZED;
+		gc = XCreateGC(walkerDpy->display_id, (Pixmap)target, 0, 0);
 
-			return EGL_FALSE;
+		if (fence)
+		{
+			glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(fence);
 		}
 
-		newConfig->drawToWindow = value & GLX_WINDOW_BIT ? EGL_TRUE : EGL_FALSE;
-		newConfig->drawToPixmap = value & GLX_PIXMAP_BIT ? EGL_TRUE : EGL_FALSE;
-		newConfig->drawToPBuffer = value & GLX_PBUFFER_BIT ? EGL_TRUE : EGL_FALSE;
+		pixels = (const char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
 
-		attribute = GLX_DOUBLEBUFFER;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->doubleBuffer))
+		// OpenGL rows are bottom up, X11 rows are top down. So the rows are flipped, while copying into the shared segment.
+		if (pixels)
 		{
-			XFree(fbConfigs);
+			int top;
 
-			*error = EGL_NOT_INITIALIZED;
+			for (top = 0; top < image->height; top++)
+			{
+				memcpy(image->data + top * image->bytes_per_line, pixels + (image->height - 1 - top) * image->bytes_per_line, (size_t)width * 4);
+			}
 
-			return EGL_FALSE;
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 		}
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-		//
+		glReadPixels(0, 0, (GLsizei)width, (GLsizei)height, GL_BGRA, GL_UNSIGNED_BYTE, image->data);
+	}
 
-		newConfig->conformant = EGL_OPENGL_BIT;
-		newConfig->renderableType = EGL_OPENGL_BIT;
-		newConfig->surfaceType = 0;
-		if (newConfig->drawToWindow)
-		{
-			newConfig->surfaceType |= EGL_WINDOW_BIT;
-		}
-		if (newConfig->drawToPixmap)
+	glReadBuffer((GLenum)readBuffer);
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)packBuffer);
+
+	if (currentRead != drawable)
+	{
+		glXMakeContextCurrent(walkerDpy->display_id, drawable, currentRead, ctx);
+	}
+
+	if (pixelBuffers && !pixels)
+	{
+		XFreeGC(walkerDpy->display_id, gc);
+
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	if (!pixelBuffers)
+	{
+		// OpenGL rows are bottom up, X11 rows are top down.
+
+		char* row = (char*)malloc((size_t)image->bytes_per_line);
+
+		if (!row)
 		{
-			newConfig->surfaceType |= EGL_PIXMAP_BIT;
+			*error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
 		}
-		if (newConfig->drawToPBuffer)
+
+		int top;
+
+		for (top = 0; top < image->height / 2; top++)
 		{
-			newConfig->surfaceType |= EGL_PBUFFER_BIT;
+			char* upper = image->data + top * image->bytes_per_line;
+			char* lower = image->data + (image->height - 1 - top) * image->bytes_per_line;
+
+			memcpy(row, upper, (size_t)image->bytes_per_line);
+			memcpy(upper, lower, (size_t)image->bytes_per_line);
+			memcpy(lower, row, (size_t)image->bytes_per_line);
 		}
-		newConfig->colorBufferType = EGL_RGB_BUFFER;
-		newConfig->configId = currentPixelFormat;
 
-		attribute = GLX_BUFFER_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bufferSize))
-		{
-			XFree(fbConfigs);
+		free(row);
 
-			*error = EGL_NOT_INITIALIZED;
+		gc = XCreateGC(walkerDpy->display_id, (Pixmap)target, 0, 0);
+	}
 
-			return EGL_FALSE;
-		}
+	if (walkerSurface->nativeSurfaceContainer.shmInfo.shmaddr)
+	{
+		XShmPutImage(walkerDpy->display_id, (Pixmap)target, gc, image, 0, 0, 0, 0, width, height, False);
+	}
+	else
+	{
+		XPutImage(walkerDpy->display_id, (Pixmap)target, gc, image, 0, 0, 0, 0, width, height);
+	}
 
-		attribute = GLX_RED_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->redSize))
-		{
-			XFree(fbConfigs);
+	XFreeGC(walkerDpy->display_id, gc);
 
-			*error = EGL_NOT_INITIALIZED;
+	// The pixmap has to be complete when returning, and the shared segment is reused.
+	XSync(walkerDpy->display_id, False);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	GLXDrawable drawable = walkerSurface->nativeSurfaceContainer.drawable;
 
-			return EGL_FALSE;
-		}
+	// Pending rendering has to reach the surface before it is used as a texture.
+	if (glXGetCurrentDrawable() == drawable)
+	{
+		glFlush();
+	}
 
-		attribute = GLX_GREEN_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->greenSize))
-		{
-			XFree(fbConfigs);
+	if (walkerSurface->nativeSurfaceContainer.pixmap)
+	{
+		glXBindTexImageEXT(walkerDpy->display_id, drawable, GLX_FRONT_LEFT_EXT, NULL);
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_TRUE;
+	}
 
-			return EGL_FALSE;
-		}
+	// Without texture from pixmap support, the color buffer is copied on the GPU.
 
-		attribute = GLX_BLUE_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->blueSize))
-		{
-			XFree(fbConfigs);
+	GLXContext ctx = glXGetCurrentContext();
 
-			*error = EGL_NOT_INITIALIZED;
+	if (!ctx)
+	{
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
+	GLXDrawable currentDraw = glXGetCurrentDrawable();
+	GLXDrawable currentRead = glXGetCurrentReadDrawable();
 
-		attribute = GLX_ALPHA_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->alphaSize))
-		{
-			XFree(fbConfigs);
+	if (!glXMakeContextCurrent(walkerDpy->display_id, currentDraw, drawable, ctx))
+	{
+		return EGL_FALSE;
+	}
 
-			*error = EGL_NOT_INITIALIZED;
+	GLint readBuffer;
 
-			return EGL_FALSE;
-		}
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+	glReadBuffer(walkerSurface->doubleBuffer && walkerSurface->renderBuffer == EGL_BACK_BUFFER ? GL_BACK : GL_FRONT);
 
-		attribute = GLX_DEPTH_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->depthSize))
-		{
-			XFree(fbConfigs);
+	glCopyTexImage2D(GL_TEXTURE_2D, 0, walkerSurface->textureFormat == EGL_TEXTURE_RGBA ? GL_RGBA : GL_RGB, 0, 0, walkerSurface->width, walkerSurface->height, 0);
 
-			*error = EGL_NOT_INITIALIZED;
+	glReadBuffer((GLenum)readBuffer);
 
-			return EGL_FALSE;
-		}
+	glXMakeContextCurrent(walkerDpy->display_id, currentDraw, currentRead, ctx);
 
-		attribute = GLX_STENCIL_SIZE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->stencilSize))
-		{
-			XFree(fbConfigs);
+	return EGL_TRUE;
+}
 
-			*error = EGL_NOT_INITIALIZED;
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
+	if (walkerSurface->nativeSurfaceContainer.pixmap)
+	{
+		glXReleaseTexImageEXT(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, GLX_FRONT_LEFT_EXT);
+	}
 
+	// A copied texture does not reference the surface.
 
-		//
+	return EGL_TRUE;
+}
 
-		attribute = GLX_SAMPLE_BUFFERS;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->sampleBuffers))
-		{
-			XFree(fbConfigs);
+#if defined(__linux__)
 
-			*error = EGL_NOT_INITIALIZED;
+static void __wakeFutex(khronos_uint32_t* address)
+{
+	// Wakes all waiters of any process.
+	syscall(SYS_futex, address, FUTEX_WAKE, 0x7FFFFFFF, 0, 0, 0);
+}
 
-			return EGL_FALSE;
-		}
+EGLBoolean __createFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint slotCount, size_t slotSize, EGLint* error)
+{
+	if (!walkerDpy || !frameRing || !error)
+	{
+		return EGL_FALSE;
+	}
 
-		attribute = GLX_SAMPLES;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->samples))
-		{
-			XFree(fbConfigs);
+	// Slots start at page boundaries, as pinned pixel buffers require.
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t slotOffset = (sizeof(EGLFrameRingDESKTOP) + pageSize - 1) / pageSize * pageSize;
 
-			*error = EGL_NOT_INITIALIZED;
+	slotSize = (slotSize + pageSize - 1) / pageSize * pageSize;
 
-			return EGL_FALSE;
-		}
+	size_t size = slotOffset + slotSize * (size_t)slotCount;
 
-		//
+	// The C library provides a wrapper only since glibc 2.27.
+	int fd = (int)syscall(SYS_memfd_create, "egl_frame_ring", MFD_CLOEXEC);
 
-		attribute = GLX_BIND_TO_TEXTURE_RGB_EXT;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGB))
-		{
-			XFree(fbConfigs);
+	if (fd < 0)
+	{
+		*error = EGL_BAD_ALLOC;
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
-		newConfig->bindToTextureRGB = newConfig->bindToTextureRGB ? EGL_TRUE : EGL_FALSE;
+	if (ftruncate(fd, (off_t)size) != 0)
+	{
+		close(fd);
 
-		attribute = GLX_BIND_TO_TEXTURE_RGBA_EXT;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGBA))
-		{
-			XFree(fbConfigs);
+		*error = EGL_BAD_ALLOC;
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
-		newConfig->bindToTextureRGBA = newConfig->bindToTextureRGBA ? EGL_TRUE : EGL_FALSE;
+	void* memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
 
-		//
+	if (memory == MAP_FAILED)
+	{
+		close(fd);
 
-		attribute = GLX_MAX_PBUFFER_PIXELS;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferPixels))
-		{
-			XFree(fbConfigs);
+		*error = EGL_BAD_ALLOC;
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
+	// The file is zero filled, so both counters start at zero.
+	EGLFrameRingDESKTOP* header = (EGLFrameRingDESKTOP*)memory;
 
-		attribute = GLX_MAX_PBUFFER_WIDTH;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferWidth))
-		{
-			XFree(fbConfigs);
+	header->magic = EGL_FRAME_RING_MAGIC_DESKTOP;
+	header->slotCount = (khronos_uint32_t)slotCount;
+	header->slotOffset = (EGLuint64KHR)slotOffset;
+	header->slotSize = (EGLuint64KHR)slotSize;
 
-			*error = EGL_NOT_INITIALIZED;
+	frameRing->header = header;
+	frameRing->size = size;
+	frameRing->fd = fd;
 
-			return EGL_FALSE;
-		}
+	return EGL_TRUE;
+}
 
-		attribute = GLX_MAX_PBUFFER_HEIGHT;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferHeight))
-		{
-			XFree(fbConfigs);
+EGLBoolean __destroyFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
 
-			*error = EGL_NOT_INITIALIZED;
+	// A consumer, which waits for the next frame, has to notice the end.
+	__atomic_store_n(&frameRing->header->closed, 1, __ATOMIC_RELEASE);
 
-			return EGL_FALSE;
-		}
+	__wakeFutex(&frameRing->header->written);
 
-		//
+	// The memory stays valid for the consumer, which has its own mapping.
+	munmap(frameRing->header, frameRing->size);
+	close(frameRing->fd);
 
-		attribute = GLX_TRANSPARENT_TYPE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentType))
-		{
-			XFree(fbConfigs);
+	frameRing->header = 0;
+	frameRing->size = 0;
+	frameRing->fd = -1;
 
-			*error = EGL_NOT_INITIALIZED;
+	return EGL_TRUE;
+}
 
-			return EGL_FALSE;
-		}
-		newConfig->transparentType = newConfig->transparentType == GLX_TRANSPARENT_RGB ? EGL_TRANSPARENT_RGB : EGL_NONE;
+EGLBoolean __waitFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint timeout)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
 
-		attribute = GLX_TRANSPARENT_RED_VALUE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentRedValue))
-		{
-			XFree(fbConfigs);
+	EGLFrameRingDESKTOP* header = frameRing->header;
 
-			*error = EGL_NOT_INITIALIZED;
+	EGLnsecsANDROID deadline = __getMonotonicTime() + (EGLnsecsANDROID)timeout * 1000000;
 
-			return EGL_FALSE;
-		}
+	while (1)
+	{
+		khronos_uint32_t read = __atomic_load_n(&header->read, __ATOMIC_ACQUIRE);
 
-		attribute = GLX_TRANSPARENT_GREEN_VALUE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentGreenValue))
+		// Counters wrap around, so only their difference is used.
+		if (header->written - read + (khronos_uint32_t)frameRing->pending < header->slotCount)
 		{
-			XFree(fbConfigs);
+			return EGL_TRUE;
+		}
 
-			*error = EGL_NOT_INITIALIZED;
+		EGLnsecsANDROID remaining = deadline - __getMonotonicTime();
 
+		if (remaining <= 0)
+		{
 			return EGL_FALSE;
 		}
 
-		attribute = GLX_TRANSPARENT_BLUE_VALUE;
-		if (glXGetFBConfigAttrib(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentBlueValue))
-		{
-			XFree(fbConfigs);
+		struct timespec relative;
 
-			*error = EGL_NOT_INITIALIZED;
+		relative.tv_sec = (time_t)(remaining / 1000000000);
+		relative.tv_nsec = (long)(remaining % 1000000000);
 
-			return EGL_FALSE;
-		}
+		// Returns at once, if the consumer did release a slot in between.
+		syscall(SYS_futex, &header->read, FUTEX_WAIT, read, &relative, 0, 0);
+	}
+}
 
-		//
+EGLBoolean __publishFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
+	}
 
-		visualInfo = glXGetVisualFromFBConfig(walkerDpy->display_id, fbConfigs[currentPixelFormat]);
+	// Pixels and the slot are visible to the consumer, before the counter is.
+	__atomic_store_n(&frameRing->header->written, frameRing->header->written + 1, __ATOMIC_RELEASE);
 
-		if (!visualInfo)
-		{
-			XFree(fbConfigs);
+	__wakeFutex(&frameRing->header->written);
 
-			*error = EGL_NOT_INITIALIZED;
+	return EGL_TRUE;
+}
 
-			return EGL_FALSE;
-		}
+#else
 
-		newConfig->nativeVisualId = visualInfo->visualid;
+EGLBoolean __createFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint slotCount, size_t slotSize, EGLint* error)
+{
+	if (!walkerDpy || !frameRing || !error)
+	{
+		return EGL_FALSE;
+	}
 
-		XFree(visualInfo);
+	// Rings need memfd and futexes of Linux, so EGL_DESKTOP_frame_ring is not advertised.
+	*error = EGL_BAD_MATCH;
 
-		// FIXME: Query and save more values.
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
+{
+	if (!walkerDpy || !frameRing || !frameRing->header)
+	{
+		return EGL_FALSE;
 	}
 
-	XFree(fbConfigs);
+	// Rings are never created.
 
-	return EGL_TRUE;
+	return EGL_FALSE;
 }
 
-EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+EGLBoolean __waitFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing, EGLint timeout)
 {
-	if (!nativeContextContainer || !walkerDpy || !nativeSurfaceContainer)
+	if (!walkerDpy || !frameRing || !frameRing->header)
 	{
 		return EGL_FALSE;
 	}
 
-	nativeContextContainer->ctx = glXCreateContextAttribsARB(walkerDpy->display_id, nativeSurfaceContainer->config, sharedNativeContextContainer ? sharedNativeContextContainer->ctx : 0, True, attribList);
+	// Rings are never created.
 
-	return nativeContextContainer->ctx != 0;
+	return EGL_FALSE;
 }
 
-EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+EGLBoolean __publishFrameRing(const EGLDisplayImpl* walkerDpy, EGLFrameRingImpl* frameRing)
 {
-	if (!walkerDpy || !nativeSurfaceContainer || !nativeContextContainer)
+	if (!walkerDpy || !frameRing || !frameRing->header)
 	{
 		return EGL_FALSE;
 	}
 
-	return (EGLBoolean)glXMakeCurrent(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeContextContainer->ctx);
+	// Rings are never created.
+
+	return EGL_FALSE;
 }
 
-EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+#endif  // __linux__
+
+EGLBoolean __bindLockContext(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
 {
 	if (!walkerDpy || !walkerSurface)
 	{
 		return EGL_FALSE;
 	}
 
-	glXSwapBuffers(walkerDpy->display_id, walkerSurface->win);
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
 
-	return EGL_TRUE;
+	// Frames of a present queue are rendered to buffers of the present thread, which are not locked.
+	if (nativeSurfaceContainer->presentQueue)
+	{
+		return EGL_FALSE;
+	}
+
+	// The surface is not current to a context of the application while it is locked, so pixels are transferred by a private context.
+	if (!nativeSurfaceContainer->lockCtx)
+	{
+		LockContext* lockCtx = walkerDpy->nativeDisplayContainer.rootLockCtx;
+
+		while (lockCtx)
+		{
+			if (lockCtx->config == nativeSurfaceContainer->config)
+			{
+				break;
+			}
+
+			lockCtx = lockCtx->next;
+		}
+
+		if (!lockCtx)
+		{
+			lockCtx = (LockContext*)malloc(sizeof(LockContext));
+
+			if (!lockCtx)
+			{
+				return EGL_FALSE;
+			}
+
+			lockCtx->config = nativeSurfaceContainer->config;
+			lockCtx->ctx = glXCreateNewContext(walkerDpy->display_id, nativeSurfaceContainer->config, GLX_RGBA_TYPE, 0, True);
+
+			if (!lockCtx->ctx)
+			{
+				free(lockCtx);
+
+				return EGL_FALSE;
+			}
+
+			lockCtx->next = walkerDpy->nativeDisplayContainer.rootLockCtx;
+			walkerDpy->nativeDisplayContainer.rootLockCtx = lockCtx;
+		}
+
+		nativeSurfaceContainer->lockCtx = lockCtx->ctx;
+	}
+
+	nativeSurfaceContainer->lockPreviousDisplay = glXGetCurrentDisplay();
+	nativeSurfaceContainer->lockPreviousDraw = glXGetCurrentDrawable();
+	nativeSurfaceContainer->lockPreviousRead = glXGetCurrentReadDrawable();
+	nativeSurfaceContainer->lockPreviousCtx = glXGetCurrentContext();
+
+	// While the surface is destroyed, the application may already have destroyed its window.
+	if (walkerSurface->destroy && walkerSurface->drawToWindow)
+	{
+		ErrorTrap errorTrap;
+
+		__beginErrorTrap(walkerDpy->display_id, &errorTrap);
+
+		Bool result = glXMakeContextCurrent(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeSurfaceContainer->drawable, nativeSurfaceContainer->lockCtx);
+
+		if (__endErrorTrap(&errorTrap))
+		{
+			result = False;
+		}
+
+		return (EGLBoolean)result;
+	}
+
+	return (EGLBoolean)glXMakeContextCurrent(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeSurfaceContainer->drawable, nativeSurfaceContainer->lockCtx);
 }
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+EGLBoolean __unbindLockContext(const EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
 {
-	if (!walkerDpy)
+	if (!walkerDpy || !walkerSurface)
 	{
 		return EGL_FALSE;
 	}
 
-	glXSwapIntervalEXT(walkerDpy->display_id, walkerDpy->currentDraw->win, interval);
+	NativeSurfaceContainer* nativeSurfaceContainer = &walkerSurface->nativeSurfaceContainer;
 
-	return EGL_TRUE;
+	if (!nativeSurfaceContainer->lockPreviousCtx)
+	{
+		return (EGLBoolean)glXMakeContextCurrent(walkerDpy->display_id, None, None, 0);
+	}
+
+	return (EGLBoolean)glXMakeContextCurrent(nativeSurfaceContainer->lockPreviousDisplay, nativeSurfaceContainer->lockPreviousDraw, nativeSurfaceContainer->lockPreviousRead, nativeSurfaceContainer->lockPreviousCtx);
 }
@@ -0,0 +1,219 @@
+/**
+ * EGL desktop implementation test: Swapping with damage takes the common swap path.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) since 2014 Norbert Nopper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#define EGL_EGLEXT_PROTOTYPES
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <EGL/egldesktopext.h>
+
+#include <GL/gl.h>
+#include <X11/Xlib.h>
+
+#include <stdio.h>
+
+#define TEST_SKIP 77
+
+typedef struct _TestWindow
+{
+	Window window;
+	EGLSurface surface;
+	EGLContext context;
+} TestWindow;
+
+static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swapBuffersWithDamage = 0;
+
+static EGLint rects[] = { 0, 0, 16, 16 };
+
+static int fail(const char* message)
+{
+	printf("FAIL: %s (EGL error 0x%x)\n", message, eglGetError());
+
+	return 1;
+}
+
+// Returns EGL_FALSE, if no configuration has the surface type.
+static EGLBoolean createTestWindow(Display* display, EGLDisplay dpy, EGLint surfaceType, TestWindow* testWindow)
+{
+	EGLint configAttribs[] = { EGL_SURFACE_TYPE, surfaceType, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+
+	EGLConfig config;
+	EGLint numConfig = 0;
+
+	if (!eglChooseConfig(dpy, configAttribs, &config, 1, &numConfig) || numConfig != 1)
+	{
+		return EGL_FALSE;
+	}
+
+	testWindow->window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 64, 48, 0, 0, 0);
+
+	testWindow->surface = eglCreateWindowSurface(dpy, config, (EGLNativeWindowType)testWindow->window, 0);
+
+	eglBindAPI(EGL_OPENGL_API);
+
+	EGLint contextAttribs[] = { EGL_NONE };
+
+	testWindow->context = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttribs);
+
+	return testWindow->surface != EGL_NO_SURFACE && testWindow->context != EGL_NO_CONTEXT && eglMakeCurrent(dpy, testWindow->surface, testWindow->surface, testWindow->context);
+}
+
+// Frames swapped with damage are exported like any other frame.
+static int testExport(Display* display, EGLDisplay dpy)
+{
+	TestWindow testWindow;
+
+	if (!createTestWindow(display, dpy, EGL_WINDOW_BIT, &testWindow))
+	{
+		return fail("createTestWindow");
+	}
+
+	if (!eglSurfaceAttrib(dpy, testWindow.surface, EGL_FRAME_EXPORT_DESKTOP, EGL_TRUE))
+	{
+		return fail("eglSurfaceAttrib EGL_FRAME_EXPORT_DESKTOP");
+	}
+
+	EGLuint64KHR frameId = 0;
+	void* pixels = 0;
+	EGLint width = 0;
+	EGLint height = 0;
+	EGLint pitch = 0;
+
+	// Frames are read back asynchronously, so the first ones may not be complete yet.
+	EGLint frame;
+
+	for (frame = 0; frame < 8 && !pixels; frame++)
+	{
+		glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		if (!swapBuffersWithDamage(dpy, testWindow.surface, rects, 1))
+		{
+			return fail("eglSwapBuffersWithDamageKHR");
+		}
+
+		if (!eglGetExportedFrameDESKTOP(dpy, testWindow.surface, &frameId, &pixels, &width, &height, &pitch))
+		{
+			return fail("eglGetExportedFrameDESKTOP");
+		}
+	}
+
+	if (!pixels)
+	{
+		return fail("Frames swapped with damage are not exported");
+	}
+
+	const unsigned char* pixel = (const unsigned char*)pixels;
+
+	if (pixel[0] != 255 || pixel[1] != 0 || pixel[2] != 0)
+	{
+		return fail("Exported frame has the wrong content");
+	}
+
+	return 0;
+}
+
+// Rendering to the front buffer is only flushed. Neither a swap nor a copy of the back buffer may overwrite it.
+static int testSingleBuffer(Display* display, EGLDisplay dpy)
+{
+	TestWindow testWindow;
+
+	if (!createTestWindow(display, dpy, EGL_WINDOW_BIT | EGL_MUTABLE_RENDER_BUFFER_BIT_KHR, &testWindow))
+	{
+		printf("No mutable render buffer, single buffer rendering is not tested.\n");
+
+		return 0;
+	}
+
+	glClearColor(0.0f, 1.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// The render buffer changes with the next swap.
+	if (!eglSurfaceAttrib(dpy, testWindow.surface, EGL_RENDER_BUFFER, EGL_SINGLE_BUFFER) || !eglSwapBuffers(dpy, testWindow.surface))
+	{
+		return fail("eglSurfaceAttrib EGL_RENDER_BUFFER");
+	}
+
+	glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if (!swapBuffersWithDamage(dpy, testWindow.surface, rects, 1))
+	{
+		return fail("eglSwapBuffersWithDamageKHR");
+	}
+
+	unsigned char pixel[4] = { 0, 0, 0, 0 };
+
+	glReadBuffer(GL_FRONT);
+	glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+	if (pixel[0] != 255 || pixel[1] != 0)
+	{
+		return fail("Front buffer rendering is overwritten by the swap");
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	Display* display = XOpenDisplay(0);
+
+	if (!display)
+	{
+		printf("SKIP: No X server.\n");
+
+		return TEST_SKIP;
+	}
+
+	EGLDisplay dpy = eglGetDisplay((EGLNativeDisplayType)display);
+
+	if (!eglInitialize(dpy, 0, 0))
+	{
+		return fail("eglInitialize");
+	}
+
+	swapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+
+	if (!swapBuffersWithDamage)
+	{
+		return fail("eglGetProcAddress eglSwapBuffersWithDamageKHR");
+	}
+
+	if (testExport(display, dpy) || testSingleBuffer(display, dpy))
+	{
+		return 1;
+	}
+
+	// Windows and surfaces are released together with the display and the connection.
+	eglTerminate(dpy);
+
+	XCloseDisplay(display);
+
+	printf("PASS\n");
+
+	return 0;
+}